@@ -6,6 +6,7 @@
 
 #define VID 0xCAFE
 #define PID 0x4003
+#define PID_ABSOLUTE 0x4002
 #define DEVICE_NAME "pico_mouse"
 
 /* Protocol Commands */
@@ -18,6 +19,20 @@
 #define CMD_LED_MAGENTA   0x06
 #define CMD_LED_WHITE     0x07
 #define CMD_LED_CUSTOM    0x08
+#define CMD_SET_REPORT_MODE 0x40
+#define CMD_SET_TUNING    0x41
+#define CMD_RECALIBRATE   0x42
+#define CMD_GET_XIP_STATS 0x43
+#define CMD_GET_USB_STATS 0x44
+#define CMD_GET_RATE_STATS 0x45
+#define CMD_GET_BOOT_TIMES 0x46
+#define CMD_EVENT_ROUTE   0x47
+#define CMD_CALIBRATE_RANGE 0x48
+#define CMD_AXIS_BENCH    0x49
+#define CMD_FW_BEGIN      0x4A
+#define CMD_FW_DATA       0x4B
+#define CMD_FW_COMMIT     0x4C
+#define CMD_LOAD_GEN      0x4D
 
 /* Events */
 #define EVENT_BTN_LEFT_PRESS    0x10
@@ -26,6 +41,8 @@
 #define EVENT_BTN_RIGHT_RELEASE 0x21
 #define EVENT_BTN_MID_PRESS     0x30
 #define EVENT_BTN_MID_RELEASE   0x31
+#define EVENT_LOAD_GEN          0x50
+#define EVENT_LOAD_TELEMETRY    0x51
 
 /* Device state */
 struct pico_mouse_dev {
@@ -264,6 +281,7 @@ static void pico_mouse_disconnect(struct usb_interface *interface)
  * -------------------------------------------------------*/
 static const struct usb_device_id pico_mouse_id_table[] = {
     { USB_DEVICE_INTERFACE_NUMBER(VID, PID, 1) }, // Interface 1 (Vendor)
+    { USB_DEVICE_INTERFACE_NUMBER(VID, PID_ABSOLUTE, 1) }, // Absolute mode
     {}
 };
 MODULE_DEVICE_TABLE(usb, pico_mouse_id_table);
@@ -0,0 +1,38 @@
+#ifndef APP_TASKS_H_
+#define APP_TASKS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#ifndef PICO_MOUSE_FREERTOS
+#define PICO_MOUSE_FREERTOS 0
+#endif
+
+// Tarefas da aplicação (main.c). No laço bare-metal todas são chamadas em
+// sequência; na variante FreeRTOS cada grupo roda na sua própria tarefa.
+void mouse_task(void);
+void mouse_sample_and_report(void);
+void load_task(void);
+void vendor_task(void);
+void command_task(void);
+void report_mode_task(void);
+void update_task(void);
+void effects_task(void);
+void heartbeat_task(void);
+void power_task(void);
+void status_led_task(void);
+void usb_supervisor_task(void);
+
+// Maior atraso entre a amostra do mouse vencer e ser lida (CMD_GET_USB_STATS)
+void hid_delay_record(uint32_t delay_us);
+
+#if PICO_MOUSE_FREERTOS
+void app_queues_init(void);
+bool event_wait(uint32_t timeout_ms);
+
+// Cria as tarefas e inicia o escalonador (rtos_tasks.c); não retorna
+void rtos_start(void);
+#endif
+
+#endif
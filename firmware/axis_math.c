@@ -0,0 +1,81 @@
+#include "pico/stdlib.h"
+#include "hardware/interp.h"
+#include "config.h"
+#include "axis_math.h"
+
+#define BENCH_DEADZONE  100
+
+void axis_math_init(void) {
+    // Lane 0: (ACCUM0 >> 12) com sinal, limitado a [BASE0, BASE1]
+    interp_config lane0 = interp_default_config();
+    interp_config_set_shift(&lane0, AXIS_SCALE_BITS);
+    interp_config_set_mask(&lane0, 0, 31 - AXIS_SCALE_BITS);
+    interp_config_set_signed(&lane0, true);
+    interp_config_set_clamp(&lane0, true);
+    interp_set_config(interp1, 0, &lane0);
+    
+    // Lane 1 só precisa do sinal: estende a metade alta do BASE_1AND0 no BASE1
+    interp_config lane1 = interp_default_config();
+    interp_config_set_signed(&lane1, true);
+    interp_set_config(interp1, 1, &lane1);
+}
+
+// Fator que leva `span` contagens do ADC a AXIS_NORM_MAX. Um lado curto
+// demais (centro colado no batente) fica limitado a CAL_RANGE_MIN_SPAN.
+static int32_t axis_scale_q12(int32_t span) {
+    if (span < CAL_RANGE_MIN_SPAN) span = CAL_RANGE_MIN_SPAN;
+    return (AXIS_NORM_MAX << AXIS_SCALE_BITS) / span;
+}
+
+void axis_norm_build(axis_norm_t *norm, uint16_t center, uint16_t min, uint16_t max) {
+    norm->center = center;
+    norm->scale_neg_q12 = axis_scale_q12((int32_t)center - (int32_t)min);
+    norm->scale_pos_q12 = axis_scale_q12((int32_t)max - (int32_t)center);
+}
+
+// ================= MICROBENCHMARK =================
+// Normalização + deadzone de uma amostra por cada caminho, sem depender de
+// PICO_MOUSE_INTERP
+static int32_t __noinline transform_scalar(const axis_norm_t *norm, uint16_t raw) {
+    int32_t diff = (int32_t)raw - norm->center;
+    int32_t scale = diff < 0 ? norm->scale_neg_q12 : norm->scale_pos_q12;
+    int32_t v = axis_clamp_scalar(diff * scale, AXIS_NORM_MAX);
+    return v - axis_clamp_scalar(v << AXIS_SCALE_BITS, BENCH_DEADZONE);
+}
+
+static int32_t __noinline transform_interp(const axis_norm_t *norm, uint16_t raw) {
+    int32_t diff = (int32_t)raw - norm->center;
+    int32_t scale = diff < 0 ? norm->scale_neg_q12 : norm->scale_pos_q12;
+    int32_t v = axis_clamp_interp(diff * scale, AXIS_NORM_MAX);
+    return v - axis_clamp_interp(v << AXIS_SCALE_BITS, BENCH_DEADZONE);
+}
+
+// Varre todo o ADC com uma faixa assimétrica típica. Roda no core que
+// chamou e bloqueia por alguns ms; interrupções no meio entram na medida.
+void axis_math_bench(uint32_t iterations, axis_bench_t *out) {
+    axis_norm_t norm;
+    axis_norm_build(&norm, 1980, 180, 3890);
+    
+    volatile int32_t sink = 0;
+    uint32_t t_start = time_us_32();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink += transform_scalar(&norm, (uint16_t)(i & 0x0FFF));
+    }
+    out->scalar_us = time_us_32() - t_start;
+    
+    t_start = time_us_32();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink += transform_interp(&norm, (uint16_t)(i & 0x0FFF));
+    }
+    out->interp_us = time_us_32() - t_start;
+    
+    out->match = true;
+    for (uint32_t raw = 0; raw <= 0x0FFF; raw++) {
+        if (transform_scalar(&norm, (uint16_t)raw) != transform_interp(&norm, (uint16_t)raw)) {
+            out->match = false;
+            break;
+        }
+    }
+    out->iterations = iterations;
+    (void)sink;
+}
@@ -0,0 +1,93 @@
+#ifndef AXIS_MATH_H_
+#define AXIS_MATH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/interp.h"
+#include "hardware/sync.h"
+#include "config.h"
+
+// Transformação de cada eixo a cada amostra: leitura do ADC → deflexão
+// normalizada (±AXIS_NORM_MAX nos batentes) → parte além da deadzone.
+// Com PICO_MOUSE_INTERP o deslocamento, a extensão de sinal e os limites
+// saem do interpolador 1 do SIO (modo clamp): uma escrita no acumulador e
+// uma leitura, sem comparações nem desvios. O resultado é idêntico ao do
+// caminho escalar. O interpolador é de cada core: todo core que chama estas
+// funções passa antes por axis_math_init(), e nada mais usa o interp1.
+// Ficam na CPU a subtração do centro, o produto pelo fator Q12 e a subtração
+// da deadzone: no modo clamp o BASE0/BASE1 são os limites, então não sobra
+// base para somar um deslocamento, o interpolador não multiplica e o blend só
+// existe no interp0. A divisão pela sensibilidade continua com '/', que o SDK
+// já leva ao divisor de hardware do SIO.
+
+#define AXIS_NORM_MAX  2047
+#define AXIS_SCALE_BITS  12     // Fatores de normalização em Q12
+
+// Um fator para cada lado do centro, refeito a cada calibração
+typedef struct {
+    int32_t center;
+    int32_t scale_neg_q12;
+    int32_t scale_pos_q12;
+} axis_norm_t;
+
+// Resultado do microbenchmark (CMD_AXIS_BENCH)
+typedef struct {
+    uint32_t iterations;
+    uint32_t scalar_us;
+    uint32_t interp_us;
+    bool match;             // Os dois caminhos concordaram em todas as amostras
+} axis_bench_t;
+
+void axis_math_init(void);
+void axis_norm_build(axis_norm_t *norm, uint16_t center, uint16_t min, uint16_t max);
+void axis_math_bench(uint32_t iterations, axis_bench_t *out);
+
+// ================= CAMINHO ESCALAR =================
+static __force_inline int32_t axis_clamp_scalar(int32_t value_q12, int32_t limit) {
+    int32_t v = value_q12 >> AXIS_SCALE_BITS;
+    if (v > limit) return limit;
+    if (v < -limit) return -limit;
+    return v;
+}
+
+// ================= CAMINHO INTERP =================
+// BASE0/BASE1 (mínimo/máximo do clamp) numa escrita só pelo BASE_1AND0.
+// No FreeRTOS a troca de contexto não salva o interpolador: uma tarefa do
+// mesmo core que entrasse entre a escrita e a leitura trocaria os limites,
+// então as três operações rodam com as interrupções do core desligadas.
+static __force_inline int32_t axis_clamp_interp(int32_t value_q12, int32_t limit) {
+#if PICO_MOUSE_FREERTOS
+    uint32_t irq_state = save_and_disable_interrupts();
+#endif
+    interp1->base01 = ((uint32_t)limit << 16) | (uint16_t)-limit;
+    interp1->accum[0] = (uint32_t)value_q12;
+    int32_t result = (int32_t)interp1->peek[0];
+#if PICO_MOUSE_FREERTOS
+    restore_interrupts(irq_state);
+#endif
+    return result;
+}
+
+static __force_inline int32_t axis_clamp(int32_t value_q12, int32_t limit) {
+#if PICO_MOUSE_INTERP
+    return axis_clamp_interp(value_q12, limit);
+#else
+    return axis_clamp_scalar(value_q12, limit);
+#endif
+}
+
+// ================= TRANSFORMAÇÃO =================
+static __force_inline int32_t axis_normalize(const axis_norm_t *norm, uint16_t raw) {
+    int32_t diff = (int32_t)raw - norm->center;
+    int32_t scale = diff < 0 ? norm->scale_neg_q12 : norm->scale_pos_q12;
+    return axis_clamp(diff * scale, AXIS_NORM_MAX);
+}
+
+// v menos o próprio v limitado a ±deadzone: 0 dentro da zona, e fora dela a
+// distância até a borda, com o sinal de v
+static __force_inline int32_t axis_deadzone(int32_t v, int32_t deadzone) {
+    if (deadzone > AXIS_NORM_MAX) deadzone = AXIS_NORM_MAX;
+    return v - axis_clamp(v << AXIS_SCALE_BITS, deadzone);
+}
+
+#endif
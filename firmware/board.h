@@ -0,0 +1,32 @@
+#ifndef BOARD_H_
+#define BOARD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Suporte à placa: pinos, LED de status e capacidades. A implementação vem
+// do PICO_BOARD no CMake: board_pico_w.c (LED onboard no chip CYW43) ou
+// board_pico.c (LED em PICO_DEFAULT_LED_PIN, sem o driver wireless).
+
+// ================= PINOS (fiação externa, igual em todas as placas) =================
+#define BUTTON_LEFT_PIN    10  // Botão A = Clique Esquerdo
+#define BUTTON_RIGHT_PIN    5  // Botão B = Clique Direito
+#define BUTTON_MIDDLE_PIN   6  // Botão Joystick = Clique Meio
+#define LED_RED_PIN        13
+#define LED_GREEN_PIN      11
+#define LED_BLUE_PIN       12
+#define JOYSTICK_X_PIN     26
+#define JOYSTICK_Y_PIN     27
+
+// ================= CAPACIDADES =================
+#define BOARD_CAP_WIRELESS       0x01   // Chip CYW43 presente
+#define BOARD_CAP_STATUS_LED     0x02   // Existe LED de status onboard
+#define BOARD_CAP_LED_SLOW_INIT  0x04   // board_status_led_init() demora (fora do boot)
+
+uint32_t board_caps(void);
+
+// Liga o LED de status; false se a placa não tem LED ou a inicialização falhou
+bool board_status_led_init(void);
+void board_status_led_put(bool on);
+
+#endif
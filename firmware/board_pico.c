@@ -0,0 +1,30 @@
+#include "pico/stdlib.h"
+#include "board.h"
+
+// Pico sem wireless: LED de status num GPIO comum (GPIO25 no Pico). Placas
+// sem PICO_DEFAULT_LED_PIN seguem sem LED de status.
+uint32_t board_caps(void) {
+#ifdef PICO_DEFAULT_LED_PIN
+    return BOARD_CAP_STATUS_LED;
+#else
+    return 0;
+#endif
+}
+
+bool board_status_led_init(void) {
+#ifdef PICO_DEFAULT_LED_PIN
+    gpio_init(PICO_DEFAULT_LED_PIN);
+    gpio_set_dir(PICO_DEFAULT_LED_PIN, GPIO_OUT);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void board_status_led_put(bool on) {
+#ifdef PICO_DEFAULT_LED_PIN
+    gpio_put(PICO_DEFAULT_LED_PIN, on);
+#else
+    (void)on;
+#endif
+}
@@ -0,0 +1,24 @@
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "board.h"
+
+// Pico W: o LED onboard é um GPIO do chip wireless, então acendê-lo exige
+// cyw43_arch_init() (carrega o firmware do CYW43, centenas de ms)
+static bool led_ready = false;
+
+uint32_t board_caps(void) {
+    return BOARD_CAP_WIRELESS | BOARD_CAP_STATUS_LED | BOARD_CAP_LED_SLOW_INIT;
+}
+
+bool board_status_led_init(void) {
+    if (!led_ready) {
+        led_ready = cyw43_arch_init() == 0;
+    }
+    return led_ready;
+}
+
+void board_status_led_put(bool on) {
+    if (led_ready) {
+        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, on);
+    }
+}
@@ -0,0 +1,104 @@
+#include "cdc_log.h"
+
+#if PICO_MOUSE_CDC_LOG
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "tusb.h"
+
+#define LOG_RING_SIZE  64       // Registros por core (potência de 2)
+#define LOG_LINE_MAX   96
+
+typedef struct {
+    uint32_t time_us;
+    const char *fmt;
+    int args[3];
+} log_record_t;
+
+// Um produtor por core (tarefa + IRQs do mesmo core) e um consumidor:
+// head só é escrito pelo core dono, tail só pelo cdc_log_task()
+typedef struct {
+    log_record_t records[LOG_RING_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+} log_ring_t;
+
+static log_ring_t rings[NUM_CORES];
+
+void cdc_log_write(const char *fmt, int a, int b, int c) {
+    log_ring_t *ring = &rings[get_core_num()];
+    
+    // Só as IRQs do próprio core concorrem aqui; nenhuma trava entre cores
+    uint32_t save = save_and_disable_interrupts();
+    uint32_t head = ring->head;
+    if (head - ring->tail >= LOG_RING_SIZE) {
+        ring->dropped++;
+    } else {
+        log_record_t *rec = &ring->records[head % LOG_RING_SIZE];
+        rec->time_us = time_us_32();
+        rec->fmt = fmt;
+        rec->args[0] = a;
+        rec->args[1] = b;
+        rec->args[2] = c;
+        __dmb();
+        ring->head = head + 1;
+    }
+    restore_interrupts(save);
+}
+
+static void log_send_line(const char *line, int len) {
+    if (len <= 0) return;
+    if (len > LOG_LINE_MAX - 1) len = LOG_LINE_MAX - 1;
+    tud_cdc_write(line, (uint32_t)len);
+}
+
+static bool log_drain_ring(log_ring_t *ring, uint8_t core) {
+    char line[LOG_LINE_MAX];
+    char msg[LOG_LINE_MAX];
+    bool wrote = false;
+    
+    if (ring->dropped && tud_cdc_write_available() >= LOG_LINE_MAX) {
+        uint32_t save = save_and_disable_interrupts();
+        uint32_t dropped = ring->dropped;
+        ring->dropped = 0;
+        restore_interrupts(save);
+        log_send_line(line, snprintf(line, sizeof(line),
+                                     "[core%u] %lu log records dropped\r\n",
+                                     core, (unsigned long)dropped));
+        wrote = true;
+    }
+    
+    if (ring->tail == ring->head) return wrote;
+    if (tud_cdc_write_available() < LOG_LINE_MAX) return wrote;
+    
+    __dmb();
+    const log_record_t *rec = &ring->records[ring->tail % LOG_RING_SIZE];
+    snprintf(msg, sizeof(msg), rec->fmt, rec->args[0], rec->args[1], rec->args[2]);
+    log_send_line(line, snprintf(line, sizeof(line), "[%5lu.%06lu c%u] %s\r\n",
+                                 (unsigned long)(rec->time_us / 1000000),
+                                 (unsigned long)(rec->time_us % 1000000),
+                                 core, msg));
+    __dmb();
+    ring->tail++;
+    return true;
+}
+
+void cdc_log_task(void) {
+    if (!tud_cdc_connected()) return;
+    
+    // Poucas linhas por chamada: o laço principal não fica preso aqui
+    bool sent = false;
+    for (int i = 0; i < 4; i++) {
+        bool any = false;
+        for (uint8_t core = 0; core < NUM_CORES; core++) {
+            any |= log_drain_ring(&rings[core], core);
+        }
+        sent |= any;
+        if (!any) break;
+    }
+    if (sent) tud_cdc_write_flush();
+}
+
+#endif
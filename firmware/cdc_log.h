@@ -0,0 +1,29 @@
+#ifndef CDC_LOG_H_
+#define CDC_LOG_H_
+
+#ifndef PICO_MOUSE_CDC_LOG
+#define PICO_MOUSE_CDC_LOG 0
+#endif
+
+// Log de depuração pela interface CDC opcional (PICO_MOUSE_CDC_LOG).
+// LOG() só guarda o ponteiro do formato, até 3 argumentos inteiros e o
+// instante em um anel por core: O(1), sem formatar e sem bloquear, pode ser
+// chamado de IRQ. cdc_log_task() formata e envia somente com a porta aberta
+// no host (DTR); sem a porta, os registros esperam e os excedentes são
+// descartados e contados.
+//
+// O formato precisa ser uma string literal e os argumentos do tipo int.
+//     LOG("usb: report mode -> %d", mode);
+
+#if PICO_MOUSE_CDC_LOG
+void cdc_log_write(const char *fmt, int a, int b, int c);
+void cdc_log_task(void);
+
+#define LOG_ARGS_(_, a, b, c, ...) (int)(a), (int)(b), (int)(c)
+#define LOG(fmt, ...) cdc_log_write(fmt, LOG_ARGS_(0, ##__VA_ARGS__, 0, 0, 0))
+#else
+#define LOG(fmt, ...) ((void)0)
+static inline void cdc_log_task(void) {}
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+// Parâmetros de compilação do firmware. Cada alvo de perfil do CMake
+// (pico_mouse_joystick_<perfil>) inclui antes o header de profiles/ com os
+// seus valores; o que o perfil não define fica com o padrão abaixo.
+#ifdef PICO_MOUSE_PROFILE_HEADER
+#include PICO_MOUSE_PROFILE_HEADER
+#endif
+
+#ifndef PICO_MOUSE_PROFILE_NAME
+#define PICO_MOUSE_PROFILE_NAME "default"
+#endif
+
+// ================= AMOSTRAGEM E USB =================
+#ifndef POLLING_RATE
+#define POLLING_RATE       30   // Amostras do joystick por segundo (Hz)
+#endif
+#ifndef HID_POLL_INTERVAL_MS
+#define HID_POLL_INTERVAL_MS 10 // bInterval do endpoint HID (1 = 1 kHz)
+#endif
+#ifndef COMMAND_BUDGET_US
+#define COMMAND_BUDGET_US  500  // Comandos vendor por passada do laço (o 1º sempre roda)
+#endif
+
+// Governador: taxa alta com entrada, descendo por níveis quando ocioso.
+// Cada nível é { taxa em Hz, ms sem entrada para chegar nele }; o primeiro é
+// a taxa com entrada ativa (use HID_POLL_INTERVAL_MS compatível com ela).
+#ifndef PICO_MOUSE_GOVERNOR
+#define PICO_MOUSE_GOVERNOR 0
+#endif
+#ifndef GOVERNOR_LEVELS
+#define GOVERNOR_LEVELS { {1000, 0}, {250, 100}, {125, 1000}, {30, 5000} }
+#endif
+
+// ================= MOVIMENTO =================
+#ifndef DEADZONE
+#define DEADZONE          150   // Padrão; ajustável via CMD_SET_TUNING
+#endif
+#ifndef SENSITIVITY
+#define SENSITIVITY        20   // Padrão; ajustável via CMD_SET_TUNING
+#endif
+// Calibração de faixa (CMD_CALIBRATE_RANGE): cada lado de cada eixo é
+// normalizado para ±2047 antes da predição e da deadzone
+#ifndef CAL_RANGE_MS
+#define CAL_RANGE_MS     5000   // Duração padrão da captura dos batentes
+#endif
+#ifndef CAL_RANGE_MIN_SPAN
+#define CAL_RANGE_MIN_SPAN 512  // Contagens mínimas do centro a cada batente
+#endif
+#ifndef PICO_MOUSE_INTERP
+#define PICO_MOUSE_INTERP   1   // Limites dos eixos no interpolador do SIO (axis_math.h)
+#endif
+#ifndef SCROLL_ON_MIDDLE
+#define SCROLL_ON_MIDDLE    0   // 1 = segurar o botão do meio rola com o eixo Y
+#endif
+#ifndef SCROLL_SPEED
+#define SCROLL_SPEED        1   // Unidades de roda (1/120 detent) por contagem de Y
+#endif
+#ifndef ABS_GAIN
+#define ABS_GAIN            8   // Unidades absolutas (0..32767) por contagem de movimento
+#endif
+
+// Predição (predictor.c): projeta a deflexão à frente para compensar a
+// latência de amostragem/USB; desligada a menos de PREDICT_REST_MARGIN
+// contagens além da deadzone
+#ifndef PICO_MOUSE_PREDICT
+#define PICO_MOUSE_PREDICT  0
+#endif
+#ifndef PREDICT_HORIZON_US
+#define PREDICT_HORIZON_US  4000    // Quanto projetar à frente
+#endif
+#ifndef PREDICT_ALPHA
+#define PREDICT_ALPHA       128     // Ganho de posição, Q8 (128 = 0,5)
+#endif
+#ifndef PREDICT_BETA
+#define PREDICT_BETA        16      // Ganho de velocidade, Q8 (16 = 0,0625)
+#endif
+#ifndef PREDICT_REST_MARGIN
+#define PREDICT_REST_MARGIN 100
+#endif
+
+// ================= EFEITOS E ENERGIA =================
+#ifndef PICO_MOUSE_EFFECTS
+#define PICO_MOUSE_EFFECTS  1   // 0 = sem piscadas do LED RGB nos cliques
+#endif
+#ifndef PICO_MOUSE_SUSPEND_CLOCKS
+#define PICO_MOUSE_SUSPEND_CLOCKS 1 // 1 = clk_sys a 48 MHz durante o suspend USB
+#endif
+
+#endif
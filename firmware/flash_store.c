@@ -0,0 +1,308 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "pico/sync.h"
+#include "hardware/flash.h"
+#include "flash_store.h"
+#include "cdc_log.h"
+
+#define STORE_MAGIC        0x53564B50u  // "PKVS"
+#define STORE_REGION_SIZE  (FLASH_STORE_SECTORS * FLASH_SECTOR_SIZE)
+#define STORE_REGION_OFFSET (PICO_FLASH_SIZE_BYTES - STORE_REGION_SIZE)
+#define STORE_COMMIT_DELAY_MS 500   // Agrupa escritas seguidas numa só gravação
+#define STORE_KEY_ERASED   0xFF
+
+// Cabeçalho no início de cada setor; seq maior = setor ativo
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+} store_sector_hdr_t;
+
+// Registro: cabeçalho + dados alinhados a 4 bytes
+typedef struct {
+    uint8_t key;
+    uint8_t len;
+    uint16_t crc;
+} store_record_hdr_t;
+
+#define RECORD_SIZE(len)   (sizeof(store_record_hdr_t) + (((len) + 3u) & ~3u))
+#define COMPACT_BUF_SIZE   (((sizeof(store_sector_hdr_t) + \
+    FLASH_STORE_MAX_KEYS * RECORD_SIZE(FLASH_STORE_MAX_VALUE)) + \
+    FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1))
+
+typedef struct {
+    uint8_t len;    // 0 = chave ausente
+    uint8_t data[FLASH_STORE_MAX_VALUE];
+} store_slot_t;
+
+typedef enum {
+    STORE_IDLE = 0,
+    STORE_COMPACT_ERASE,
+    STORE_COMPACT_WRITE,
+} store_state_t;
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *data;
+    uint32_t len;     // 0 = apagar setor
+} store_flash_op_t;
+
+// slots/dirty_mask/last_set_ms: no FreeRTOS a calibração grava pelo core 1
+// enquanto o flash_store_task() serializa no core 0. A trava nunca fica presa
+// durante uma operação de flash (o flash_safe_execute() para o outro core).
+static critical_section_t store_lock;
+static store_slot_t slots[FLASH_STORE_MAX_KEYS];
+static uint16_t dirty_mask = 0;
+static uint32_t last_set_ms = 0;
+
+static uint8_t active_sector = 0;
+static uint32_t active_seq = 0;
+static uint32_t write_offset = 0;   // Relativo ao início do setor ativo
+
+static store_state_t state = STORE_IDLE;
+static uint8_t compact_sector = 0;
+static uint32_t compact_len = 0;
+static int compact_page = 0;
+static uint8_t compact_buf[COMPACT_BUF_SIZE];
+static uint8_t page_buf[2 * FLASH_PAGE_SIZE];
+
+// ================= FUNÇÕES AUXILIARES =================
+static uint16_t crc16_ccitt(uint16_t crc, const uint8_t *data, uint32_t len) {
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t record_crc(uint8_t key, uint8_t len, const uint8_t *data) {
+    uint8_t hdr[2] = {key, len};
+    return crc16_ccitt(crc16_ccitt(0xFFFF, hdr, 2), data, len);
+}
+
+static uint32_t sector_offset(uint8_t sector) {
+    return STORE_REGION_OFFSET + (uint32_t)sector * FLASH_SECTOR_SIZE;
+}
+
+static const uint8_t *sector_ptr(uint8_t sector) {
+    return (const uint8_t *)(XIP_BASE + sector_offset(sector));
+}
+
+// Executado com interrupções desligadas e o outro core fora da flash
+static void store_flash_op(void *param) {
+    const store_flash_op_t *op = (const store_flash_op_t *)param;
+    if (op->len == 0) {
+        flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+    } else {
+        flash_range_program(op->offset, op->data, op->len);
+    }
+}
+
+static bool store_flash_exec(uint32_t offset, const uint8_t *data, uint32_t len) {
+    store_flash_op_t op = { .offset = offset, .data = data, .len = len };
+    int rc = flash_safe_execute(store_flash_op, &op, 100);
+    if (rc != PICO_OK) {
+        LOG("flash_store: flash op (len %d, 0 = erase) at 0x%x failed", len, offset);
+    }
+    return rc == PICO_OK;
+}
+
+static uint32_t serialize_record(uint8_t *dst, uint8_t key) {
+    const store_slot_t *slot = &slots[key];
+    store_record_hdr_t hdr = {
+        .key = key,
+        .len = slot->len,
+        .crc = record_crc(key, slot->len, slot->data),
+    };
+    uint32_t size = RECORD_SIZE(slot->len);
+
+    memset(dst, 0xFF, size);
+    memcpy(dst, &hdr, sizeof(hdr));
+    memcpy(dst + sizeof(hdr), slot->data, slot->len);
+    return size;
+}
+
+// ================= LEITURA NO BOOT =================
+static uint32_t replay_sector(uint8_t sector) {
+    const uint8_t *base = sector_ptr(sector);
+    uint32_t off = sizeof(store_sector_hdr_t);
+
+    while (off + sizeof(store_record_hdr_t) <= FLASH_SECTOR_SIZE) {
+        store_record_hdr_t hdr;
+        memcpy(&hdr, base + off, sizeof(hdr));
+
+        if (hdr.key == STORE_KEY_ERASED) return off;
+        if (hdr.key >= FLASH_STORE_MAX_KEYS || hdr.len > FLASH_STORE_MAX_VALUE ||
+            off + RECORD_SIZE(hdr.len) > FLASH_SECTOR_SIZE ||
+            hdr.crc != record_crc(hdr.key, hdr.len, base + off + sizeof(hdr))) {
+            // Registro interrompido por queda de energia: setor cheio, compactar
+            return FLASH_SECTOR_SIZE;
+        }
+        slots[hdr.key].len = hdr.len;
+        memcpy(slots[hdr.key].data, base + off + sizeof(hdr), hdr.len);
+        off += RECORD_SIZE(hdr.len);
+    }
+    return FLASH_SECTOR_SIZE;
+}
+
+void flash_store_init(void) {
+    bool found = false;
+
+    critical_section_init(&store_lock);
+    memset(slots, 0, sizeof(slots));
+    for (uint8_t s = 0; s < FLASH_STORE_SECTORS; s++) {
+        store_sector_hdr_t hdr;
+        memcpy(&hdr, sector_ptr(s), sizeof(hdr));
+        if (hdr.magic != STORE_MAGIC) continue;
+        if (!found || (int32_t)(hdr.seq - active_seq) > 0) {
+            active_sector = s;
+            active_seq = hdr.seq;
+            found = true;
+        }
+    }
+
+    if (found) {
+        write_offset = replay_sector(active_sector);
+    } else {
+        // Flash virgem: a primeira gravação cria o setor 0 via compactação
+        active_sector = FLASH_STORE_SECTORS - 1;
+        active_seq = 0;
+        write_offset = FLASH_SECTOR_SIZE;
+    }
+}
+
+// ================= API =================
+bool flash_store_get(uint8_t key, void *out, uint8_t len) {
+    if (key >= FLASH_STORE_MAX_KEYS) return false;
+
+    critical_section_enter_blocking(&store_lock);
+    bool found = slots[key].len == len;
+    if (found) memcpy(out, slots[key].data, len);
+    critical_section_exit(&store_lock);
+    return found;
+}
+
+bool flash_store_set(uint8_t key, const void *data, uint8_t len) {
+    if (key >= FLASH_STORE_MAX_KEYS || len == 0 || len > FLASH_STORE_MAX_VALUE) return false;
+
+    store_slot_t *slot = &slots[key];
+    critical_section_enter_blocking(&store_lock);
+    if (slot->len != len || memcmp(slot->data, data, len) != 0) {
+        slot->len = len;
+        memcpy(slot->data, data, len);
+        dirty_mask |= (uint16_t)(1u << key);
+        last_set_ms = to_ms_since_boot(get_absolute_time());
+    }
+    critical_section_exit(&store_lock);
+    return true;
+}
+
+bool flash_store_pending(void) {
+    return dirty_mask != 0 || state != STORE_IDLE;
+}
+
+// ================= GRAVAÇÃO INCREMENTAL =================
+static void compact_begin(void) {
+    uint32_t off = sizeof(store_sector_hdr_t);
+
+    // Setores usados em rodízio: o desgaste se espalha por toda a região
+    compact_sector = (uint8_t)((active_sector + 1) % FLASH_STORE_SECTORS);
+
+    memset(compact_buf, 0xFF, sizeof(compact_buf));
+    critical_section_enter_blocking(&store_lock);
+    for (uint8_t key = 0; key < FLASH_STORE_MAX_KEYS; key++) {
+        if (slots[key].len == 0) continue;
+        off += serialize_record(&compact_buf[off], key);
+    }
+    dirty_mask = 0;
+    critical_section_exit(&store_lock);
+    store_sector_hdr_t hdr = { .magic = STORE_MAGIC, .seq = active_seq + 1 };
+    memcpy(compact_buf, &hdr, sizeof(hdr));
+
+    compact_len = off;
+    compact_page = (int)((off - 1) / FLASH_PAGE_SIZE);
+    state = STORE_COMPACT_ERASE;
+}
+
+static void compact_step(void) {
+    if (state == STORE_COMPACT_ERASE) {
+        if (store_flash_exec(sector_offset(compact_sector), NULL, 0)) {
+            state = STORE_COMPACT_WRITE;
+        }
+        return;
+    }
+
+    // Da última página para a primeira: o cabeçalho (página 0) confirma o setor
+    uint32_t page_off = (uint32_t)compact_page * FLASH_PAGE_SIZE;
+    if (!store_flash_exec(sector_offset(compact_sector) + page_off,
+                          &compact_buf[page_off], FLASH_PAGE_SIZE)) {
+        return;
+    }
+    if (--compact_page >= 0) return;
+
+    active_sector = compact_sector;
+    active_seq++;
+    write_offset = compact_len;
+    state = STORE_IDLE;
+}
+
+// A chave sai de dirty_mask quando é serializada, sob a trava: um
+// flash_store_set() durante a gravação marca de novo e o valor novo vai no
+// próximo passo. Se a flash recusar, a chave volta a ficar suja.
+static void append_step(void) {
+    uint8_t key = 0;
+
+    critical_section_enter_blocking(&store_lock);
+    while (!(dirty_mask & (1u << key))) key++;
+
+    uint32_t size = RECORD_SIZE(slots[key].len);
+    if (write_offset + size > FLASH_SECTOR_SIZE) {
+        critical_section_exit(&store_lock);
+        compact_begin();
+        return;
+    }
+
+    // Programa só as páginas tocadas pelo registro; bytes 0xFF não alteram a flash
+    uint32_t page_start = write_offset & ~(FLASH_PAGE_SIZE - 1);
+    uint32_t in_page = write_offset - page_start;
+    uint32_t prog_len = (in_page + size > FLASH_PAGE_SIZE) ? 2 * FLASH_PAGE_SIZE : FLASH_PAGE_SIZE;
+
+    memset(page_buf, 0xFF, sizeof(page_buf));
+    serialize_record(&page_buf[in_page], key);
+    dirty_mask &= (uint16_t)~(1u << key);
+    critical_section_exit(&store_lock);
+
+    if (!store_flash_exec(sector_offset(active_sector) + page_start, page_buf, prog_len)) {
+        critical_section_enter_blocking(&store_lock);
+        dirty_mask |= (uint16_t)(1u << key);
+        critical_section_exit(&store_lock);
+        return;
+    }
+    write_offset += size;
+}
+
+static void store_step(void) {
+    if (state != STORE_IDLE) {
+        compact_step();
+    } else if (dirty_mask) {
+        append_step();
+    }
+}
+
+void flash_store_task(void) {
+    if (!flash_store_pending()) return;
+
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if (state == STORE_IDLE && now - last_set_ms < STORE_COMMIT_DELAY_MS) return;
+
+    store_step();
+}
+
+void flash_store_flush(void) {
+    // Limite de passos: não trava o firmware se a flash recusar a operação
+    for (int i = 0; i < 64 && flash_store_pending(); i++) {
+        store_step();
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef FLASH_STORE_H_
+#define FLASH_STORE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Armazenamento chave/valor em log nos últimos setores da flash.
+// Os valores ficam em RAM após flash_store_init(); flash_store_set() só
+// marca a chave como suja e flash_store_task() grava aos poucos, no máximo
+// uma operação de flash (apagar um setor ou programar até duas páginas)
+// por chamada, via flash_safe_execute() (código em RAM, outro core parado).
+// get/set podem ser chamadas de qualquer core; task/flush, de um só.
+
+#ifndef FLASH_STORE_SECTORS
+#define FLASH_STORE_SECTORS 4
+#endif
+
+#define FLASH_STORE_MAX_KEYS  16
+#define FLASH_STORE_MAX_VALUE 32
+
+enum {
+    STORE_KEY_REPORT_MODE = 0x01,
+    STORE_KEY_CALIBRATION = 0x02,
+    STORE_KEY_TUNING      = 0x03,
+    STORE_KEY_LED         = 0x04,
+};
+
+void flash_store_init(void);
+bool flash_store_get(uint8_t key, void *out, uint8_t len);
+bool flash_store_set(uint8_t key, const void *data, uint8_t len);
+bool flash_store_pending(void);
+void flash_store_flush(void);
+void flash_store_task(void);
+
+#endif
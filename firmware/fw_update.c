@@ -0,0 +1,196 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/watchdog.h"
+#include "fw_update.h"
+#include "cdc_log.h"
+
+#define BOOT2_SIZE        256   // Boot2 + checksum nos últimos 4 bytes
+#define CRC32_MPEG2_POLY  0x04C11DB7u
+
+typedef enum {
+    FW_IDLE = 0,
+    FW_RECEIVING,
+    FW_VERIFIED,
+} fw_state_t;
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *data;    // NULL = apagar setor
+} fw_flash_op_t;
+
+static fw_state_t state = FW_IDLE;
+static uint32_t image_size = 0;
+static uint32_t image_crc = 0;
+static uint32_t received = 0;
+static uint32_t erased_end = 0;     // Relativo ao slot
+
+// Página em montagem; na instalação, buffer da cópia (tem que estar na SRAM)
+static uint32_t page_buf[FLASH_PAGE_SIZE / 4];
+
+// ================= FUNÇÕES AUXILIARES =================
+// CRC-32/MPEG-2 (sem reflexão, sem XOR final): o mesmo do checksum do boot2
+static uint32_t crc32_mpeg2(uint32_t crc, const uint8_t *data, uint32_t len) {
+    while (len--) {
+        crc ^= (uint32_t)(*data++) << 24;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x80000000u) ? (crc << 1) ^ CRC32_MPEG2_POLY : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static const uint8_t *slot_ptr(void) {
+    return (const uint8_t *)(XIP_BASE + FW_UPDATE_SLOT_OFFSET);
+}
+
+// Executado com interrupções desligadas e o outro core fora da flash
+static void fw_flash_op(void *param) {
+    const fw_flash_op_t *op = (const fw_flash_op_t *)param;
+    if (op->data == NULL) {
+        flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+    } else {
+        flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+    }
+}
+
+static bool fw_flash_exec(uint32_t offset, const uint8_t *data) {
+    fw_flash_op_t op = { .offset = offset, .data = data };
+    int rc = flash_safe_execute(fw_flash_op, &op, 100);
+    if (rc != PICO_OK) {
+        LOG("fw_update: flash op at 0x%x failed (%d)", offset, rc);
+    }
+    return rc == PICO_OK;
+}
+
+// Apaga o setor na hora da primeira página dele: a espera de cada apagamento
+// fica diluída entre os blocos em vez de somada no início
+static bool page_program(uint32_t page_off) {
+    if (page_off >= erased_end) {
+        if (!fw_flash_exec(FW_UPDATE_SLOT_OFFSET + erased_end, NULL)) return false;
+        erased_end += FLASH_SECTOR_SIZE;
+    }
+    return fw_flash_exec(FW_UPDATE_SLOT_OFFSET + page_off, (const uint8_t *)page_buf);
+}
+
+// ================= RECEPÇÃO =================
+fw_status_t fw_update_begin(uint32_t size, uint32_t crc) {
+    if (!PICO_MOUSE_FW_UPDATE) return FW_ERR_DISABLED;
+    if (size < BOOT2_SIZE || size > FW_UPDATE_SLOT_SIZE) {
+        state = FW_IDLE;
+        return FW_ERR_SIZE;
+    }
+    image_size = size;
+    image_crc = crc;
+    received = 0;
+    erased_end = 0;
+    state = FW_RECEIVING;
+    LOG("fw_update: receiving %d bytes, crc 0x%08x", size, crc);
+    return FW_OK;
+}
+
+fw_status_t fw_update_data(uint32_t offset, const uint8_t *data, uint32_t len) {
+    if (state != FW_RECEIVING) return FW_ERR_STATE;
+    if (offset < received && len <= received - offset) return FW_OK;   // Repetido após reenvio do host
+    if (offset != received) return FW_ERR_OFFSET;
+    if (len > image_size - received) return FW_ERR_SIZE;
+    
+    uint8_t *page = (uint8_t *)page_buf;
+    while (len > 0) {
+        uint32_t in_page = received % FLASH_PAGE_SIZE;
+        uint32_t n = MIN(len, FLASH_PAGE_SIZE - in_page);
+        memcpy(&page[in_page], data, n);
+        received += n;
+        data += n;
+        len -= n;
+        
+        if (received % FLASH_PAGE_SIZE == 0 && !page_program(received - FLASH_PAGE_SIZE)) {
+            state = FW_IDLE;
+            return FW_ERR_FLASH;
+        }
+    }
+    return FW_OK;
+}
+
+fw_status_t fw_update_verify(void) {
+    if (state != FW_RECEIVING || received != image_size) return FW_ERR_STATE;
+    
+    // Última página incompleta: o resto fica apagado (0xFF)
+    uint32_t tail = received % FLASH_PAGE_SIZE;
+    if (tail != 0) {
+        memset((uint8_t *)page_buf + tail, 0xFF, FLASH_PAGE_SIZE - tail);
+        if (!page_program(received - tail)) {
+            state = FW_IDLE;
+            return FW_ERR_FLASH;
+        }
+    }
+    
+    const uint8_t *slot = slot_ptr();
+    uint32_t crc = crc32_mpeg2(0xFFFFFFFFu, slot, image_size);
+    if (crc != image_crc) {
+        LOG("fw_update: crc 0x%08x, expected 0x%08x", crc, image_crc);
+        state = FW_IDLE;
+        return FW_ERR_CRC;
+    }
+    
+    // O bootrom só executa o boot2 com este checksum: sem ele a imagem não dá boot
+    uint32_t boot2_crc;
+    memcpy(&boot2_crc, slot + BOOT2_SIZE - 4, sizeof(boot2_crc));
+    if (crc32_mpeg2(0xFFFFFFFFu, slot, BOOT2_SIZE - 4) != boot2_crc) {
+        LOG("fw_update: image has no valid boot2");
+        state = FW_IDLE;
+        return FW_ERR_IMAGE;
+    }
+    
+    state = FW_VERIFIED;
+    LOG("fw_update: image verified");
+    return FW_OK;
+}
+
+uint32_t fw_update_received(void) {
+    return received;
+}
+
+bool fw_update_active(void) {
+    return state != FW_IDLE;
+}
+
+// ================= INSTALAÇÃO =================
+#if PICO_MOUSE_FW_UPDATE
+// Depois do primeiro apagamento no offset 0 o código na flash já não é o
+// deste firmware: tudo até o reboot roda da SRAM (as funções flash_range_*
+// do SDK também), e a cópia é palavra a palavra por ponteiro volatile para
+// o compilador não trocar o laço por uma chamada de memcpy().
+static void __no_inline_not_in_flash_func(fw_install_copy)(void *param) {
+    uint32_t size = *(const uint32_t *)param;
+    const volatile uint32_t *src = (const volatile uint32_t *)(XIP_BASE + FW_UPDATE_SLOT_OFFSET);
+    
+    for (uint32_t off = 0; off < size; off += FLASH_PAGE_SIZE) {
+        if (off % FLASH_SECTOR_SIZE == 0) {
+            flash_range_erase(off, FLASH_SECTOR_SIZE);
+        }
+        for (uint32_t i = 0; i < FLASH_PAGE_SIZE / 4; i++) {
+            page_buf[i] = src[(off / 4) + i];
+        }
+        flash_range_program(off, (const uint8_t *)page_buf, FLASH_PAGE_SIZE);
+    }
+    
+    hw_set_bits(&watchdog_hw->ctrl, WATCHDOG_CTRL_TRIGGER_BITS);
+    while (true) tight_loop_contents();
+}
+
+void fw_update_install(void) {
+    if (state != FW_VERIFIED) return;
+    
+    uint32_t size = image_size;
+    LOG("fw_update: installing %d bytes", size);
+    flash_safe_execute(fw_install_copy, &size, 100);
+    
+    // Só volta se o outro core não parou a tempo: nada foi apagado
+    LOG("fw_update: install aborted, flash lockout failed");
+}
+#else
+void fw_update_install(void) {
+}
+#endif
@@ -0,0 +1,61 @@
+#ifndef FW_UPDATE_H_
+#define FW_UPDATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/flash.h"
+#include "flash_store.h"
+
+#ifndef PICO_MOUSE_FW_UPDATE
+#define PICO_MOUSE_FW_UPDATE 0
+#endif
+
+// Atualização do firmware pelos comandos vendor. A imagem (binário de flash
+// completo, com o boot2 no início) chega em blocos e é gravada no slot de
+// staging, na metade de cima da flash: cada setor é apagado quando o
+// primeiro byte dele chega e cada página é programada ao completar. No fim o
+// CRC e o checksum do boot2 são conferidos lendo a flash de volta.
+//
+// O RP2040 só dá boot no offset 0 e não há bootloader para alternar entre
+// slots: a instalação copia o slot para o offset 0 por uma função na SRAM,
+// com interrupções desligadas e o outro core parado, e reinicia pelo
+// watchdog. Uma queda de energia durante a cópia (alguns segundos) deixa a
+// flash sem firmware válido; o BOOTSEL do bootrom continua disponível.
+// Por isso a atualização só existe nos builds de depuração com
+// PICO_MOUSE_FW_UPDATE (cmake -DPICO_MOUSE_FW_UPDATE=ON); sem ele
+// fw_update_begin() responde FW_ERR_DISABLED e a cópia nem é compilada.
+
+#define FW_UPDATE_SLOT_OFFSET (PICO_FLASH_SIZE_BYTES / 2)
+#define FW_UPDATE_SLOT_SIZE   (PICO_FLASH_SIZE_BYTES / 2 - FLASH_STORE_SECTORS * FLASH_SECTOR_SIZE)
+
+typedef enum {
+    FW_OK = 0,
+    FW_ERR_STATE,       // Sem atualização em andamento, já verificada ou instalação agendada
+    FW_ERR_SIZE,        // Imagem vazia ou maior que o slot
+    FW_ERR_OFFSET,      // Bloco fora de ordem: o host retoma de `received`
+    FW_ERR_FLASH,       // flash_safe_execute() recusou a operação
+    FW_ERR_CRC,         // CRC da imagem gravada não confere
+    FW_ERR_IMAGE,       // Checksum do boot2 inválido: não é imagem de flash do RP2040
+    FW_ERR_DISABLED,    // Build sem PICO_MOUSE_FW_UPDATE
+} fw_status_t;
+
+// Começa uma atualização; `crc` = CRC-32/MPEG-2 da imagem inteira
+fw_status_t fw_update_begin(uint32_t size, uint32_t crc);
+
+// Blocos em ordem, sem lacunas; repetir um bloco já recebido é ignorado
+fw_status_t fw_update_data(uint32_t offset, const uint8_t *data, uint32_t len);
+
+// Grava a última página e confere a imagem no slot
+fw_status_t fw_update_verify(void);
+
+// Bytes já aceitos (próximo offset esperado)
+uint32_t fw_update_received(void);
+
+bool fw_update_active(void);
+
+// Só depois de fw_update_verify() == FW_OK. Copia o slot para o offset 0 e
+// reinicia pelo watchdog; só retorna se o outro core não parou (nada mudou).
+// Antes, o chamador desliga o watchdog e grava o motivo do reset.
+void fw_update_install(void);
+
+#endif
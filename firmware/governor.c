@@ -0,0 +1,81 @@
+#include "pico/stdlib.h"
+#include "config.h"
+#include "governor.h"
+#include "hot_path.h"
+
+#if PICO_MOUSE_GOVERNOR
+static const governor_level_t levels[] = GOVERNOR_LEVELS;
+#else
+static const governor_level_t levels[] = { { POLLING_RATE, 0 } };
+#endif
+
+#define LEVEL_COUNT (sizeof(levels) / sizeof(levels[0]))
+_Static_assert(LEVEL_COUNT <= GOVERNOR_MAX_LEVELS, "GOVERNOR_LEVELS: too many levels");
+
+static uint8_t level = 0;
+static uint64_t last_active_us = 0;
+static uint64_t level_since_us = 0;
+static uint64_t time_in_level_us[LEVEL_COUNT];
+
+static void set_level(uint8_t next, uint64_t now) {
+    time_in_level_us[level] += now - level_since_us;
+    level_since_us = now;
+    level = next;
+}
+
+void governor_init(void) {
+    uint64_t now = time_us_64();
+    level = 0;
+    last_active_us = now;
+    level_since_us = now;
+    for (uint8_t i = 0; i < LEVEL_COUNT; i++) time_in_level_us[i] = 0;
+}
+
+bool HOT_PATH_FUNC(governor_update)(bool active) {
+    uint64_t now = time_us_64();
+    
+    if (active) {
+        last_active_us = now;
+        if (level == 0) return false;
+        set_level(0, now);
+        return true;
+    }
+    
+    if (level + 1u >= LEVEL_COUNT) return false;
+    
+    // Desce um nível por vez, mesmo que o tempo ocioso já cubra vários
+    uint64_t idle_ms = (now - last_active_us) / 1000;
+    if (idle_ms < levels[level + 1].idle_ms) return false;
+    set_level(level + 1, now);
+    return true;
+}
+
+uint32_t HOT_PATH_FUNC(governor_period_us)(void) {
+    return 1000000u / levels[level].rate_hz;
+}
+
+uint8_t governor_level(void) {
+    return level;
+}
+
+uint8_t governor_level_count(void) {
+    return LEVEL_COUNT;
+}
+
+const governor_level_t *governor_levels(void) {
+    return levels;
+}
+
+void governor_time_in_level(uint32_t *out_ms) {
+    uint64_t now = time_us_64();
+    for (uint8_t i = 0; i < LEVEL_COUNT; i++) {
+        uint64_t t = time_in_level_us[i];
+        if (i == level) t += now - level_since_us;
+        out_ms[i] = (uint32_t)(t / 1000);
+    }
+}
+
+void governor_reset_stats(void) {
+    level_since_us = time_us_64();
+    for (uint8_t i = 0; i < LEVEL_COUNT; i++) time_in_level_us[i] = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef GOVERNOR_H_
+#define GOVERNOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Governador da taxa de amostragem/relatórios. Com PICO_MOUSE_GOVERNOR a
+// taxa começa no nível 0 (a mais alta) e desce um nível sempre que o tempo
+// sem entrada passa do limite do nível seguinte (GOVERNOR_LEVELS); qualquer
+// entrada volta ao nível 0 na mesma amostra. Sem o governador existe um só
+// nível, em POLLING_RATE.
+
+#define GOVERNOR_MAX_LEVELS 8
+
+typedef struct {
+    uint16_t rate_hz;
+    uint32_t idle_ms;   // Tempo sem entrada para chegar a este nível
+} governor_level_t;
+
+void governor_init(void);
+
+// Chamado a cada amostra; true se o nível (e o período) mudou
+bool governor_update(bool active);
+
+uint32_t governor_period_us(void);
+uint8_t governor_level(void);
+uint8_t governor_level_count(void);
+const governor_level_t *governor_levels(void);
+
+// Tempo acumulado em cada nível (ms), incluindo o nível atual até agora
+void governor_time_in_level(uint32_t *out_ms);
+void governor_reset_stats(void);
+
+#endif
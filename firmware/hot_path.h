@@ -0,0 +1,18 @@
+#ifndef HOT_PATH_H_
+#define HOT_PATH_H_
+
+#include "pico/platform.h"
+
+#ifndef PICO_MOUSE_RAM_HOT_PATH
+#define PICO_MOUSE_RAM_HOT_PATH 0
+#endif
+
+// Funções do caminho joystick → relatório HID → USB. Com PICO_MOUSE_RAM_HOT_PATH
+// elas são ligadas na SRAM e não sofrem com falhas do cache XIP da flash.
+#if PICO_MOUSE_RAM_HOT_PATH
+#define HOT_PATH_FUNC(f) __not_in_flash_func(f)
+#else
+#define HOT_PATH_FUNC(f) f
+#endif
+
+#endif
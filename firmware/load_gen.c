@@ -0,0 +1,113 @@
+#include "pico/stdlib.h"
+#include "load_gen.h"
+#include "cdc_log.h"
+
+static load_pattern_t pattern = LOAD_OFF;
+static uint32_t period_us = 0;
+static uint32_t duration_us = 0;
+static uint32_t start_us = 0;
+static uint32_t next_us = 0;         // Instante do próximo evento
+static uint8_t burst_len = 0;
+static uint8_t burst_left = 0;
+static uint32_t rng_state = 0;
+static load_gen_stats_t stats;
+
+// xorshift32: barato e suficiente para espalhar os intervalos
+static uint32_t rng_next(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state = x;
+    return x;
+}
+
+// Avança a agenda um evento conforme o padrão
+static void schedule_next(void) {
+    switch (pattern) {
+        case LOAD_BURSTY:
+            if (--burst_left > 0) return;
+            burst_left = burst_len;
+            next_us += period_us * burst_len;
+            break;
+        case LOAD_RANDOM:
+            next_us += 1 + rng_next() % (2 * period_us);
+            break;
+        default:
+            next_us += period_us;
+            break;
+    }
+}
+
+bool load_gen_start(load_pattern_t new_pattern, uint32_t rate_hz, uint32_t duration_ms,
+                    uint8_t burst) {
+    if (new_pattern == LOAD_OFF || new_pattern >= LOAD_PATTERN_COUNT) return false;
+    if (rate_hz == 0 || rate_hz > LOAD_GEN_MAX_RATE_HZ || duration_ms == 0) return false;
+    
+    period_us = 1000000u / rate_hz;
+    duration_us = duration_ms * 1000u;
+    burst_len = burst > 0 ? burst : LOAD_GEN_BURST_DEFAULT;
+    burst_left = burst_len;
+    start_us = time_us_32();
+    next_us = start_us;
+    rng_state = start_us | 1;
+    stats.generated = 0;
+    stats.ring_full = 0;
+    stats.elapsed_us = 0;
+    stats.skipped = 0;
+    pattern = new_pattern;
+    LOG("load: pattern %d at %d Hz for %d ms", new_pattern, rate_hz, duration_ms);
+    return true;
+}
+
+void load_gen_stop(void) {
+    if (pattern == LOAD_OFF) return;
+    stats.elapsed_us = time_us_32() - start_us;
+    pattern = LOAD_OFF;
+    LOG("load: %d events in %d us, %d refused (queue full)", stats.generated,
+        stats.elapsed_us, stats.ring_full);
+    if (stats.skipped > 0) {
+        LOG("load: %d events skipped, generator fell behind", stats.skipped);
+    }
+}
+
+load_pattern_t load_gen_pattern(void) {
+    return pattern;
+}
+
+uint32_t load_gen_period_us(void) {
+    return period_us;
+}
+
+bool load_gen_next(uint32_t now_us, uint32_t *seq) {
+    if (pattern == LOAD_OFF) return false;
+    if (now_us - start_us >= duration_us) {
+        load_gen_stop();
+        return false;
+    }
+    if ((int32_t)(now_us - next_us) < 0) return false;
+    
+    // Só os últimos LOAD_GEN_MAX_PER_PASS períodos de atraso são gerados
+    uint32_t behind = (now_us - next_us) / period_us;
+    if (behind > LOAD_GEN_MAX_PER_PASS) {
+        uint32_t skip = behind - LOAD_GEN_MAX_PER_PASS;
+        next_us += skip * period_us;
+        burst_left = burst_len;
+        stats.skipped += skip;
+    }
+    
+    *seq = stats.generated++;
+    schedule_next();
+    return true;
+}
+
+void load_gen_refused(void) {
+    stats.ring_full++;
+}
+
+void load_gen_get_stats(load_gen_stats_t *out) {
+    *out = stats;
+    if (pattern != LOAD_OFF) {
+        out->elapsed_us = time_us_32() - start_us;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef LOAD_GEN_H_
+#define LOAD_GEN_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Gerador de carga sintética (CMD_LOAD_GEN) para testar o caminho IN do
+// vendor e o host em taxas que os botões nunca alcançam. Decide quando cada
+// evento vence e o numera; quem chama põe o evento na fila de eventos. A
+// agenda é por tempo absoluto: uma passada atrasada gera os eventos vencidos
+// de uma vez (até LOAD_GEN_MAX_PER_PASS por passada) em vez de perdê-los.
+// Um atraso maior que LOAD_GEN_MAX_PER_PASS eventos (laço parado) não vira
+// rajada: os eventos mais antigos não são gerados e contam em `skipped`, sem
+// consumir números de sequência. A cada LOAD_GEN_TELEMETRY_EVERY números um
+// sai como registro de telemetria em vez de evento simples.
+
+#define LOAD_GEN_MAX_RATE_HZ   20000
+#define LOAD_GEN_MAX_PER_PASS  32
+#define LOAD_GEN_BURST_DEFAULT 8
+#define LOAD_GEN_DURATION_DEFAULT_MS 5000
+#define LOAD_GEN_TELEMETRY_EVERY 16
+
+typedef enum {
+    LOAD_OFF = 0,
+    LOAD_CONSTANT,      // Intervalo fixo de 1/taxa
+    LOAD_BURSTY,        // Rajadas de `burst` eventos seguidos, mesma taxa média
+    LOAD_RANDOM,        // Intervalo uniforme em (0, 2/taxa], mesma taxa média
+    LOAD_PATTERN_COUNT,
+} load_pattern_t;
+
+typedef struct {
+    uint32_t generated;     // Números de sequência emitidos (0..generated-1)
+    uint32_t ring_full;     // Desses, recusados com a fila de eventos cheia
+    uint32_t elapsed_us;    // Tempo de geração (até agora, se ainda ativo)
+    uint32_t skipped;       // Vencidos e não gerados: o gerador ficou para trás
+} load_gen_stats_t;
+
+// false com padrão ou taxa inválidos; `burst` = 0 usa LOAD_GEN_BURST_DEFAULT
+bool load_gen_start(load_pattern_t pattern, uint32_t rate_hz, uint32_t duration_ms,
+                    uint8_t burst);
+void load_gen_stop(void);
+load_pattern_t load_gen_pattern(void);
+
+// Intervalo médio entre eventos (para acordar o laço a tempo)
+uint32_t load_gen_period_us(void);
+
+// true se um evento venceu em `now_us`, com o número de sequência em `*seq`;
+// depois da duração o gerador encerra e retorna false
+bool load_gen_next(uint32_t now_us, uint32_t *seq);
+
+static inline bool load_gen_is_telemetry(uint32_t seq) {
+    return seq % LOAD_GEN_TELEMETRY_EVERY == LOAD_GEN_TELEMETRY_EVERY - 1;
+}
+
+// O último evento de load_gen_next() não coube na fila
+void load_gen_refused(void);
+
+void load_gen_get_stats(load_gen_stats_t *out);
+
+#endif
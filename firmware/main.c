@@ -1,22 +1,43 @@
 #include "pico/stdlib.h"
-#include "pico/cyw43_arch.h"
 #include "tusb.h"
 #include "hardware/adc.h"
 #include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "usb_descriptors.h"
+#include "flash_store.h"
+#include "board.h"
+#include "config.h"
+#include "hot_path.h"
+#include "timer_service.h"
+#include "cdc_log.h"
+#include "governor.h"
+#include "usb_watchdog.h"
+#include "predictor.h"
+#include "axis_math.h"
+#include "fw_update.h"
+#include "load_gen.h"
+#include "app_tasks.h"
+
+#if PICO_MOUSE_FREERTOS
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+#endif
 
 // ================= CONFIGURAÇÃO =================
-#define BUTTON_LEFT_PIN    10  // Botão A = Clique Esquerdo
-#define BUTTON_RIGHT_PIN    5  // Botão B = Clique Direito
-#define BUTTON_MIDDLE_PIN   6  // Botão Joystick = Clique Meio
-#define LED_RED_PIN        13
-#define LED_GREEN_PIN      11
-#define LED_BLUE_PIN       12
-#define JOYSTICK_X_PIN     26
-#define JOYSTICK_Y_PIN     27
-#define DEADZONE          150
-#define SENSITIVITY        20
-#define MAX_SPEED         127
-#define POLLING_RATE       30
+// Ajustes de movimento, taxa e efeitos: config.h / profiles/; pinos: board.h
+#define MAX_SPEED         127   // Limite do protocolo boot (8 bits)
+#define MAX_SPEED_HIRES 32767   // Limite do relatório de 16 bits
+#define MOTION_ACCUM_MAX (1 << 20)  // Teto dos acumuladores com o host sem ler o endpoint
+#define REENUM_DELAY_MS    50   // Tempo desconectado ao trocar de modo
+#define HEARTBEAT_MS      500   // Meio período do pisca do LED onboard sem USB
+#define WAKE_POLL_MS       50   // Leitura do joystick durante o suspend (remote wakeup)
+#define CAL_SAMPLES        50   // Amostras do centro na calibração (uma por amostragem)
+#define STATUS_LED_INIT_MS 2000 // Sem relatório até aqui, inicia o LED onboard mesmo assim
+#define FW_INSTALL_DELAY_MS 100 // Resposta do CMD_FW_COMMIT sai antes da instalação
+#define LOAD_TICK_MIN_US   100  // Menor período do alarme que acorda o laço no CMD_LOAD_GEN
 
 // ================= PROTOCOLO VENDOR =================
 #define CMD_LED_OFF       0x00
@@ -28,6 +49,20 @@
 #define CMD_LED_MAGENTA   0x06
 #define CMD_LED_WHITE     0x07
 #define CMD_LED_CUSTOM    0x08
+#define CMD_SET_REPORT_MODE 0x40
+#define CMD_SET_TUNING    0x41
+#define CMD_RECALIBRATE   0x42
+#define CMD_GET_XIP_STATS 0x43
+#define CMD_GET_USB_STATS 0x44
+#define CMD_GET_RATE_STATS 0x45
+#define CMD_GET_BOOT_TIMES 0x46
+#define CMD_EVENT_ROUTE   0x47
+#define CMD_CALIBRATE_RANGE 0x48
+#define CMD_AXIS_BENCH    0x49
+#define CMD_FW_BEGIN      0x4A
+#define CMD_FW_DATA       0x4B
+#define CMD_FW_COMMIT     0x4C
+#define CMD_LOAD_GEN      0x4D
 
 #define EVENT_BTN_LEFT_PRESS    0x10
 #define EVENT_BTN_LEFT_RELEASE  0x11
@@ -35,50 +70,367 @@
 #define EVENT_BTN_RIGHT_RELEASE 0x21
 #define EVENT_BTN_MID_PRESS     0x30
 #define EVENT_BTN_MID_RELEASE   0x31
+#define EVENT_LOAD_GEN          0x50    // [seq u32 LE][time_us_32() u32 LE] (CMD_LOAD_GEN)
+#define EVENT_LOAD_TELEMETRY    0x51    // + [x i16][y i16][fila u8][recusados u16] (LE)
 
 // ================= VARIÁVEIS GLOBAIS =================
 static bool usb_connected = false;
-static uint16_t center_x = 2048;
-static uint16_t center_y = 2048;
+static volatile bool usb_suspended = false;
+static bool low_power = false;
+static volatile bool remote_wakeup_allowed = false; // Host habilitou (SET_FEATURE)
+static volatile bool wake_request = false;
+static volatile uint8_t wake_buttons = 0;   // Botões que acordaram o host (bits do relatório)
+static uint8_t current_color[3] = {0, 0, 0};
 static bool calibrated = false;
+static bool range_capture = false;
 static bool btn_left_prev = false;
 static bool btn_right_prev = false;
 static bool btn_mid_prev = false;
+static bool wheel_hires = false;
+static int32_t wheel_accum = 0;
+static int32_t motion_x = 0;            // Movimento ainda não enviado ao host
+static int32_t motion_y = 0;
+static uint8_t report_buttons = 0;      // Botões da amostra mais recente
+static int32_t abs_x = ABS_COORD_MAX / 2;
+static int32_t abs_y = ABS_COORD_MAX / 2;
+static volatile int16_t axis_last_x = 0;    // Última deflexão normalizada (telemetria)
+static volatile int16_t axis_last_y = 0;
+#if PICO_MOUSE_PREDICT
+static predictor_axis_t predict_x;
+static predictor_axis_t predict_y;
+static uint32_t predict_last_us = 0;
+#endif
+
+// Valores persistidos no flash_store
+typedef struct {
+    uint16_t center_x;
+    uint16_t center_y;
+    uint16_t min_x;             // Batentes medidos por CMD_CALIBRATE_RANGE;
+    uint16_t max_x;             // sem captura, a faixa inteira do ADC
+    uint16_t min_y;
+    uint16_t max_y;
+} calibration_t;
+
+// Formato antigo do registro, só com o centro: ainda aceito no boot
+typedef struct {
+    uint16_t center_x;
+    uint16_t center_y;
+} calibration_v1_t;
+
+#define ADC_MAX        4095
+
+static calibration_t calibration = { 2048, 2048, 0, ADC_MAX, 0, ADC_MAX };
+
+// Tabela de normalização de cada eixo (axis_math.c), refeita a cada calibração
+static axis_norm_t norm_x;
+static axis_norm_t norm_y;
+
+typedef struct {
+    uint16_t deadzone;
+    uint16_t sensitivity;
+} tuning_t;
+
+static tuning_t tuning = { DEADZONE, SENSITIVITY };
+static uint8_t host_color[3] = {0, 255, 0};
+
+// Último relatório enviado com os campos relativos zerados: é o estado atual
+// do dispositivo (GET_REPORT) e a base da supressão de relatórios repetidos
+#define REPORT_STATE_MAX 8
+static uint8_t report_state[REPORT_STATE_MAX];
+static uint8_t report_state_len = 0;    // 0 = nada enviado desde o mount
+static uint8_t report_state_id = 0;
+static uint32_t last_report_us = 0;
+static volatile uint8_t hid_idle_rate = 0;  // SET_IDLE, em 4 ms; 0 = só na mudança
+
+// Canal dos comandos vendor: a interface vendor (driver) ou a coleção vendor
+// do HID (hidraw). Respostas voltam pelo canal do comando; eventos vão pelo
+// canal escolhido com CMD_EVENT_ROUTE (interface vendor após cada mount).
+typedef enum {
+    CHANNEL_VENDOR = 0,
+    CHANNEL_HID,
+} vendor_channel_t;
+
+static vendor_channel_t command_channel = CHANNEL_VENDOR;
+static volatile vendor_channel_t event_channel = CHANNEL_VENDOR;
+
+// Resposta pelo hidraw (GET_FEATURE): [estado][resposta...]. O byte de estado
+// leva nos bits 7-2 o número do SET_FEATURE a que se refere (conta a cada
+// comando, módulo 64) e nos bits 1-0 o estado dele; a leitura não consome,
+// então repetir o GET_FEATURE devolve o mesmo
+#define FEATURE_PENDING   0     // Na fila, ainda não executado
+#define FEATURE_READY     1     // Resposta nos bytes seguintes
+#define FEATURE_NO_REPLY  2     // Executado, o comando não tem resposta
+#define FEATURE_DROPPED   3     // Fila de comandos cheia, descartado
+#define FEATURE_STATUS(seq, state) ((uint8_t)(((seq) << 2) | (state)))
+
+static uint8_t hid_feature_reply[HID_VENDOR_REPORT_SIZE - 1];
+static uint8_t hid_feature_reply_len = 0;
+static volatile uint8_t hid_feature_status = FEATURE_STATUS(0, FEATURE_NO_REPLY);
+static uint8_t hid_feature_seq = 0;     // Do último SET_FEATURE
+static uint8_t command_seq = 0;         // Do comando em execução
+
+// Contadores de saúde do USB no dispositivo (CMD_GET_USB_STATS). A ordem dos
+// campos é a ordem na resposta; novos campos só entram no fim.
+typedef struct {
+    uint32_t sof;               // SOFs recebidos (1 por ms com o barramento ativo)
+    uint32_t reports_sent;      // Relatórios HID aceitos pelo TinyUSB
+    uint32_t reports_suppressed;// Iguais ao estado anterior, não enviados
+    uint32_t reports_failed;    // tud_hid_report() recusou o relatório
+    uint32_t hid_busy;          // Tentativas de envio com o endpoint HID ocupado
+    uint32_t vendor_rx_bytes;
+    uint32_t vendor_tx_bytes;
+    uint32_t vendor_tx_full;    // Evento/resposta esperando sem espaço no endpoint
+    uint32_t events_dropped;    // event_push() com a fila cheia
+    uint32_t event_queue_hwm;   // Maior ocupação da fila de eventos
+    uint32_t mounts;            // Enumerações (inclui as após reset de barramento)
+    uint32_t suspends;
+    uint32_t remote_wakeups;    // tud_remote_wakeup() emitidos pelo dispositivo
+    uint32_t stall_reconnects;  // Reconexões forçadas pelo supervisor (usb_watchdog.c)
+    uint32_t hid_delay_max_us;  // Maior atraso entre a amostra vencer e ser lida
+} usb_stats_t;
+
+// Na variante FreeRTOS a entrada (core 1) e o USB/telemetria (core 0) contam
+// ao mesmo tempo: cada core só escreve na sua cópia e a leitura soma as
+// cópias, sem ++ concorrente no mesmo campo. No bare-metal há uma cópia só.
+#if PICO_MOUSE_FREERTOS
+#define USB_STATS_COPIES NUM_CORES
+#else
+#define USB_STATS_COPIES 1
+#endif
+static usb_stats_t usb_stats_core[USB_STATS_COPIES];
+static usb_stats_t usb_stats_base;      // Totais no último reset (só o core 0 escreve)
+
+static inline usb_stats_t *usb_stats_local(void) {
+#if PICO_MOUSE_FREERTOS
+    return &usb_stats_core[get_core_num()];
+#else
+    return &usb_stats_core[0];
+#endif
+}
+
+// Marcos do boot em µs desde o reset (CMD_GET_BOOT_TIMES); 0 = ainda não ocorreu
+typedef struct {
+    uint32_t mount_us;          // Primeira enumeração
+    uint32_t first_report_us;   // Primeiro relatório HID aceito
+    uint32_t status_led_us;     // LED onboard pronto (cyw43 no Pico W)
+} boot_times_t;
+
+static boot_times_t boot_times;
+
+// Tempo de montagem de cada relatório (mouse_task), para medir jitter
+static uint32_t hot_samples = 0;
+static uint32_t hot_max_us = 0;
+static uint32_t hot_total_us = 0;
+static volatile bool mode_switch_pending = false;
+static volatile uint8_t mode_switch_target = REPORT_MODE_RELATIVE;
 
 #define EVENT_QUEUE_SIZE 16
+#define EVENT_DATA_MAX   16
 typedef struct {
     uint8_t type;
-    uint8_t data[3];
+    uint8_t data[EVENT_DATA_MAX];
     uint8_t len;
 } vendor_event_t;
 
+// Comando vendor recebido, à espera do command_task(): os callbacks do
+// TinyUSB só copiam, a execução fica fora do tud_task()
+#define COMMAND_QUEUE_SIZE 4    // Comandos esperando (o app conta com isso)
+#define COMMAND_MAX_LEN    64
+typedef struct {
+    uint8_t channel;            // vendor_channel_t de origem (canal da resposta)
+    uint8_t seq;                // Número do SET_FEATURE (canal HID)
+    uint8_t len;
+    uint8_t data[COMMAND_MAX_LEN];
+} vendor_command_t;
+
+// Pedido de piscada do LED (entrada → efeitos)
+typedef struct {
+    uint8_t rgb[3];
+    uint16_t duration_ms;
+} led_flash_t;
+
+#if PICO_MOUSE_FREERTOS
+// Entrada, telemetria e efeitos rodam em tarefas separadas: filas do FreeRTOS
+static QueueHandle_t event_queue;
+static QueueHandle_t effect_queue;
+static QueueHandle_t command_queue;
+static TaskHandle_t telemetry_waiter;   // Tarefa parada no event_wait()
+#else
 static vendor_event_t event_queue[EVENT_QUEUE_SIZE];
 static volatile uint8_t event_head = 0;
 static volatile uint8_t event_tail = 0;
+static led_flash_t pending_flash;
+static volatile bool flash_pending = false;
+// Uma posição a mais: o anel com head == tail vazio guarda N - 1
+static vendor_command_t command_queue[COMMAND_QUEUE_SIZE + 1];
+static volatile uint8_t command_head = 0;
+static volatile uint8_t command_tail = 0;
+#endif
+
+// Temporizadores de cada tarefa (alarm pool, resolução de µs)
+static soft_timer_t mouse_timer;
+static soft_timer_t heartbeat_timer;
+static soft_timer_t flash_timer;
+static soft_timer_t reenum_timer;
+static soft_timer_t wake_poll_timer;
+static soft_timer_t range_timer;
+static soft_timer_t update_timer;
+static soft_timer_t load_timer;
 
 // ================= FUNÇÕES AUXILIARES =================
-static bool event_push(uint8_t type, const uint8_t *data, uint8_t len) {
-    uint8_t next = (event_head + 1) % EVENT_QUEUE_SIZE;
-    if (next == event_tail) return false;
-    
-    event_queue[event_head].type = type;
-    event_queue[event_head].len = len > 3 ? 3 : len;
+#if PICO_MOUSE_FREERTOS
+// Eventos e comandos acordam a tarefa de telemetria na hora
+static void HOT_PATH_FUNC(telemetry_wake)(void) {
+    TaskHandle_t waiter = telemetry_waiter;
+    if (waiter) xTaskNotifyGive(waiter);
+}
+#endif
+
+static uint32_t HOT_PATH_FUNC(event_depth)(void) {
+#if PICO_MOUSE_FREERTOS
+    return uxQueueMessagesWaiting(event_queue);
+#else
+    return (uint32_t)(event_head - event_tail + EVENT_QUEUE_SIZE) % EVENT_QUEUE_SIZE;
+#endif
+}
+
+static bool HOT_PATH_FUNC(event_push)(uint8_t type, const uint8_t *data, uint8_t len) {
+    vendor_event_t event = { .type = type, .len = MIN(len, EVENT_DATA_MAX) };
     if (data && len > 0) {
-        memcpy(event_queue[event_head].data, data, event_queue[event_head].len);
+        memcpy(event.data, data, event.len);
+    }
+    
+#if PICO_MOUSE_FREERTOS
+    if (xQueueSend(event_queue, &event, 0) != pdTRUE) {
+        usb_stats_local()->events_dropped++;
+        return false;
     }
+    telemetry_wake();
+#else
+    uint8_t next = (event_head + 1) % EVENT_QUEUE_SIZE;
+    if (next == event_tail) {
+        usb_stats_local()->events_dropped++;
+        return false;
+    }
+    
+    event_queue[event_head] = event;
     event_head = next;
+#endif
+    uint32_t depth = event_depth();
+    usb_stats_t *stats = usb_stats_local();
+    if (depth > stats->event_queue_hwm) stats->event_queue_hwm = depth;
     return true;
 }
 
-static bool event_pop(vendor_event_t *out) {
+static bool HOT_PATH_FUNC(event_pending)(void) {
+#if PICO_MOUSE_FREERTOS
+    return uxQueueMessagesWaiting(event_queue) != 0;
+#else
+    return event_tail != event_head;
+#endif
+}
+
+static bool HOT_PATH_FUNC(event_pop)(vendor_event_t *out) {
+#if PICO_MOUSE_FREERTOS
+    return xQueueReceive(event_queue, out, 0) == pdTRUE;
+#else
     if (event_tail == event_head) return false;
     *out = event_queue[event_tail];
     event_tail = (event_tail + 1) % EVENT_QUEUE_SIZE;
     return true;
+#endif
+}
+
+// Chamado nos callbacks do TinyUSB; comando maior que COMMAND_MAX_LEN é truncado
+static bool command_push(vendor_channel_t channel, uint8_t seq, const uint8_t *data, uint16_t len) {
+    vendor_command_t cmd = { .channel = (uint8_t)channel, .seq = seq,
+                             .len = (uint8_t)MIN(len, COMMAND_MAX_LEN) };
+    memcpy(cmd.data, data, cmd.len);
+    
+#if PICO_MOUSE_FREERTOS
+    if (xQueueSend(command_queue, &cmd, 0) != pdTRUE) {
+        LOG("vendor: command 0x%02x dropped, queue full", data[0]);
+        return false;
+    }
+    telemetry_wake();
+#else
+    uint8_t next = (command_head + 1) % (COMMAND_QUEUE_SIZE + 1);
+    if (next == command_tail) {
+        LOG("vendor: command 0x%02x dropped, queue full", data[0]);
+        return false;
+    }
+    command_queue[command_head] = cmd;
+    command_head = next;
+#endif
+    return true;
+}
+
+static bool command_pending(void) {
+#if PICO_MOUSE_FREERTOS
+    return uxQueueMessagesWaiting(command_queue) != 0;
+#else
+    return command_tail != command_head;
+#endif
+}
+
+static bool command_pop(vendor_command_t *out) {
+#if PICO_MOUSE_FREERTOS
+    return xQueueReceive(command_queue, out, 0) == pdTRUE;
+#else
+    if (command_tail == command_head) return false;
+    *out = command_queue[command_tail];
+    command_tail = (command_tail + 1) % (COMMAND_QUEUE_SIZE + 1);
+    return true;
+#endif
+}
+
+#if PICO_MOUSE_FREERTOS
+void app_queues_init(void) {
+    event_queue = xQueueCreate(EVENT_QUEUE_SIZE, sizeof(vendor_event_t));
+    effect_queue = xQueueCreate(1, sizeof(led_flash_t));
+    command_queue = xQueueCreate(COMMAND_QUEUE_SIZE, sizeof(vendor_command_t));
+}
+
+// Espera um evento ou comando; a notificação pode ter chegado antes da espera
+bool event_wait(uint32_t timeout_ms) {
+    telemetry_waiter = xTaskGetCurrentTaskHandle();
+    if (event_pending() || command_pending()) return true;
+    return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) != 0;
+}
+#endif
+
+// Só registra o pedido: quem acende/apaga é o effects_task()
+static void HOT_PATH_FUNC(led_flash)(uint8_t red, uint8_t green, uint8_t blue, uint16_t duration_ms) {
+#if PICO_MOUSE_EFFECTS
+    led_flash_t req = { .rgb = {red, green, blue}, .duration_ms = duration_ms };
+#if PICO_MOUSE_FREERTOS
+    xQueueOverwrite(effect_queue, &req);
+#else
+    pending_flash = req;
+    flash_pending = true;
+#endif
+#else
+    // Perfil sem efeitos: nada é enfileirado
+    (void)red; (void)green; (void)blue; (void)duration_ms;
+#endif
+}
+
+static bool led_flash_take(led_flash_t *out) {
+#if PICO_MOUSE_FREERTOS
+    return xQueueReceive(effect_queue, out, 0) == pdTRUE;
+#else
+    if (!flash_pending) return false;
+    *out = pending_flash;
+    flash_pending = false;
+    return true;
+#endif
 }
 
 // ================= LED RGB =================
 void set_rgb_color(uint8_t red, uint8_t green, uint8_t blue) {
+    current_color[0] = red;
+    current_color[1] = green;
+    current_color[2] = blue;
     pwm_set_gpio_level(LED_RED_PIN, 255 - red);
     pwm_set_gpio_level(LED_GREEN_PIN, 255 - green);
     pwm_set_gpio_level(LED_BLUE_PIN, 255 - blue);
@@ -100,110 +452,857 @@ void init_rgb_led(void) {
     set_rgb_color(0, 0, 0);
 }
 
+// Cor escolhida pelo host: aplicada e lembrada entre reinicializações
+void set_host_color(uint8_t red, uint8_t green, uint8_t blue) {
+    host_color[0] = red;
+    host_color[1] = green;
+    host_color[2] = blue;
+    set_rgb_color(red, green, blue);
+    flash_store_set(STORE_KEY_LED, host_color, sizeof(host_color));
+}
+
 void handle_led_command(uint8_t cmd, const uint8_t *data, uint8_t len) {
     switch (cmd) {
-        case CMD_LED_OFF:     set_rgb_color(0, 0, 0); break;
-        case CMD_LED_RED:     set_rgb_color(255, 0, 0); break;
-        case CMD_LED_GREEN:   set_rgb_color(0, 255, 0); break;
-        case CMD_LED_BLUE:    set_rgb_color(0, 0, 255); break;
-        case CMD_LED_YELLOW:  set_rgb_color(255, 255, 0); break;
-        case CMD_LED_CYAN:    set_rgb_color(0, 255, 255); break;
-        case CMD_LED_MAGENTA: set_rgb_color(255, 0, 255); break;
-        case CMD_LED_WHITE:   set_rgb_color(255, 255, 255); break;
+        case CMD_LED_OFF:     set_host_color(0, 0, 0); break;
+        case CMD_LED_RED:     set_host_color(255, 0, 0); break;
+        case CMD_LED_GREEN:   set_host_color(0, 255, 0); break;
+        case CMD_LED_BLUE:    set_host_color(0, 0, 255); break;
+        case CMD_LED_YELLOW:  set_host_color(255, 255, 0); break;
+        case CMD_LED_CYAN:    set_host_color(0, 255, 255); break;
+        case CMD_LED_MAGENTA: set_host_color(255, 0, 255); break;
+        case CMD_LED_WHITE:   set_host_color(255, 255, 255); break;
         case CMD_LED_CUSTOM:
             if (len >= 4) {
-                set_rgb_color(data[1], data[2], data[3]);
+                set_host_color(data[1], data[2], data[3]);
+            }
+            break;
+    }
+}
+
+// Respostas a comandos começam com o código do comando (eventos usam 0x10-0x31)
+static void vendor_reply(const uint8_t *buf, uint16_t len) {
+    if (command_channel == CHANNEL_HID) {
+        // Lida pelo host com GET_FEATURE; um SET_FEATURE mais novo já tomou o
+        // lugar desta resposta (o callback roda em outra tarefa no FreeRTOS)
+        uint32_t save = save_and_disable_interrupts();
+        if (command_seq == hid_feature_seq) {
+            hid_feature_reply_len = (uint8_t)MIN(len, sizeof(hid_feature_reply));
+            memcpy(hid_feature_reply, buf, hid_feature_reply_len);
+            hid_feature_status = FEATURE_STATUS(command_seq, FEATURE_READY);
+        }
+        restore_interrupts(save);
+        return;
+    }
+    if (!tud_vendor_mounted()) return;
+    if (tud_vendor_write_available() < len) {
+        usb_stats_local()->vendor_tx_full++;
+        return;
+    }
+    usb_stats_local()->vendor_tx_bytes += tud_vendor_write(buf, len);
+    tud_vendor_flush();
+}
+
+static void send_xip_stats(bool reset);
+static void send_usb_stats(bool reset);
+static void send_rate_stats(bool reset);
+static void send_boot_times(void);
+static void send_axis_bench(void);
+static void fw_begin(const uint8_t *data, uint16_t len);
+static void fw_data(const uint8_t *data, uint16_t len);
+static void fw_commit(void);
+static void load_command(const uint8_t *data, uint16_t len);
+void calibrate_joystick(void);
+void calibrate_range_start(uint32_t duration_ms);
+
+void handle_vendor_command(const uint8_t *data, uint16_t len) {
+    uint8_t cmd = data[0];
+    
+    if (cmd <= CMD_LED_CUSTOM) {
+        handle_led_command(cmd, data, len);
+        return;
+    }
+    
+    switch (cmd) {
+        case CMD_SET_REPORT_MODE:
+            // A re-enumeração acontece fora do contexto do tud_task()
+            if (len >= 2 && data[1] < REPORT_MODE_COUNT) {
+                mode_switch_target = data[1];
+                mode_switch_pending = true;
             }
             break;
+        case CMD_SET_TUNING:
+            // [1..2] deadzone (LE), [3] sensibilidade (divisor, >= 1)
+            if (len >= 4 && data[3] > 0) {
+                tuning.deadzone = (uint16_t)(data[1] | (data[2] << 8));
+                tuning.sensitivity = data[3];
+                flash_store_set(STORE_KEY_TUNING, &tuning, sizeof(tuning));
+                LOG("tuning: deadzone=%d sensitivity=%d", tuning.deadzone, tuning.sensitivity);
+            }
+            break;
+        case CMD_RECALIBRATE:
+            calibrate_joystick();
+            break;
+        case CMD_CALIBRATE_RANGE:
+            // [1] = duração da captura em segundos (0 ou ausente = CAL_RANGE_MS)
+            calibrate_range_start(len >= 2 && data[1] > 0 ? data[1] * 1000u : CAL_RANGE_MS);
+            break;
+        case CMD_AXIS_BENCH:
+            send_axis_bench();
+            break;
+        case CMD_FW_BEGIN:
+            // [1..4] tamanho da imagem, [5..8] CRC-32/MPEG-2 (LE)
+            fw_begin(data, len);
+            break;
+        case CMD_FW_DATA:
+            // [1..4] offset (LE), [5..] dados
+            fw_data(data, len);
+            break;
+        case CMD_FW_COMMIT:
+            fw_commit();
+            break;
+        case CMD_LOAD_GEN:
+            // [1] padrão (0 = parar), [2..3] taxa em Hz (LE), [4] duração em s
+            // (0 = padrão), [5] eventos por rajada
+            load_command(data, len);
+            break;
+        case CMD_GET_XIP_STATS:
+            // [1] = 1 zera os contadores após a leitura
+            send_xip_stats(len >= 2 && data[1] == 1);
+            break;
+        case CMD_GET_USB_STATS:
+            // [1] = 1 zera os contadores após a leitura
+            send_usb_stats(len >= 2 && data[1] == 1);
+            break;
+        case CMD_GET_RATE_STATS:
+            // [1] = 1 zera o tempo acumulado por nível após a leitura
+            send_rate_stats(len >= 2 && data[1] == 1);
+            break;
+        case CMD_GET_BOOT_TIMES:
+            send_boot_times();
+            break;
+        case CMD_EVENT_ROUTE:
+            // Eventos passam a sair pelo canal deste comando
+            event_channel = command_channel;
+            LOG("vendor: events routed to channel %d", command_channel);
+            break;
+        default:
+            LOG("vendor: unknown command 0x%02x (len %d)", cmd, len);
+            break;
+    }
+}
+
+// ================= ESTATÍSTICAS XIP =================
+static void put_u32_le(uint8_t *dst, uint32_t v) {
+    dst[0] = (uint8_t)v;
+    dst[1] = (uint8_t)(v >> 8);
+    dst[2] = (uint8_t)(v >> 16);
+    dst[3] = (uint8_t)(v >> 24);
+}
+
+static void put_u16_le(uint8_t *dst, uint16_t v) {
+    dst[0] = (uint8_t)v;
+    dst[1] = (uint8_t)(v >> 8);
+}
+
+static uint32_t get_u32_le(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+           ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+// Resposta: [0x43][flags][hit][acc][amostras][max_us][total_us] (u32 LE)
+static void send_xip_stats(bool reset) {
+    uint8_t buf[22];
+    
+    buf[0] = CMD_GET_XIP_STATS;
+    buf[1] = PICO_MOUSE_RAM_HOT_PATH ? 0x01 : 0x00;
+    put_u32_le(&buf[2], xip_ctrl_hw->ctr_hit);
+    put_u32_le(&buf[6], xip_ctrl_hw->ctr_acc);
+    put_u32_le(&buf[10], hot_samples);
+    put_u32_le(&buf[14], hot_max_us);
+    put_u32_le(&buf[18], hot_total_us);
+    vendor_reply(buf, sizeof(buf));
+    
+    if (reset) {
+        // Qualquer escrita zera os contadores do cache XIP
+        xip_ctrl_hw->ctr_hit = 0;
+        xip_ctrl_hw->ctr_acc = 0;
+        hot_samples = 0;
+        hot_max_us = 0;
+        hot_total_us = 0;
+    }
+}
+
+// ================= ESTATÍSTICAS USB =================
+// Campos que guardam um máximo em vez de uma contagem
+static bool usb_stat_is_max(uint8_t index) {
+    return index == offsetof(usb_stats_t, event_queue_hwm) / sizeof(uint32_t) ||
+           index == offsetof(usb_stats_t, hid_delay_max_us) / sizeof(uint32_t);
+}
+
+// Soma das cópias de cada core (máximo, nos campos de máximo)
+static uint32_t usb_stat_total(uint8_t index) {
+    uint32_t total = 0;
+    for (uint8_t core = 0; core < USB_STATS_COPIES; core++) {
+        uint32_t v = ((const volatile uint32_t *)&usb_stats_core[core])[index];
+        total = usb_stat_is_max(index) ? MAX(total, v) : total + v;
+    }
+    return total;
+}
+
+// Resposta: [0x44][n][n contadores u32 LE na ordem de usb_stats_t]. O reset
+// guarda os totais como base em vez de zerar as cópias do outro core.
+static void send_usb_stats(bool reset) {
+    uint8_t buf[2 + sizeof(usb_stats_t)];
+    uint32_t *base = (uint32_t *)&usb_stats_base;
+    uint8_t count = sizeof(usb_stats_t) / sizeof(uint32_t);
+    
+    buf[0] = CMD_GET_USB_STATS;
+    buf[1] = count;
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t total = usb_stat_total(i);
+        bool is_max = usb_stat_is_max(i);
+        put_u32_le(&buf[2 + 4 * i], is_max ? total : total - base[i]);
+        
+        if (!reset) continue;
+        if (is_max) {
+            // Um máximo que o outro core grave durante o zeramento pode se perder
+            for (uint8_t core = 0; core < USB_STATS_COPIES; core++) {
+                ((volatile uint32_t *)&usb_stats_core[core])[i] = 0;
+            }
+        } else {
+            base[i] = total;
+        }
+    }
+    vendor_reply(buf, sizeof(buf));
+}
+
+// ================= ESTATÍSTICAS DO GOVERNADOR =================
+// Resposta: [0x45][flags bit0 = governador][nível atual][n]
+//           n × [taxa Hz u16 LE][tempo no nível ms u32 LE]
+static void send_rate_stats(bool reset) {
+    uint8_t buf[4 + GOVERNOR_MAX_LEVELS * 6];
+    uint32_t time_ms[GOVERNOR_MAX_LEVELS];
+    const governor_level_t *levels = governor_levels();
+    uint8_t count = governor_level_count();
+    
+    governor_time_in_level(time_ms);
+    buf[0] = CMD_GET_RATE_STATS;
+    buf[1] = PICO_MOUSE_GOVERNOR ? 0x01 : 0x00;
+    buf[2] = governor_level();
+    buf[3] = count;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t *p = &buf[4 + 6 * i];
+        p[0] = (uint8_t)levels[i].rate_hz;
+        p[1] = (uint8_t)(levels[i].rate_hz >> 8);
+        put_u32_le(&p[2], time_ms[i]);
+    }
+    vendor_reply(buf, (uint16_t)(4 + 6 * count));
+    
+    if (reset) {
+        governor_reset_stats();
+    }
+}
+
+// ================= TEMPOS DE BOOT =================
+// Resposta: [0x46][montagem][primeiro relatório][LED onboard] (u32 LE, µs)
+//           [motivo do reset][resets pelo watchdog u32 LE]
+static void send_boot_times(void) {
+    uint8_t buf[18];
+    
+    buf[0] = CMD_GET_BOOT_TIMES;
+    put_u32_le(&buf[1], boot_times.mount_us);
+    put_u32_le(&buf[5], boot_times.first_report_us);
+    put_u32_le(&buf[9], boot_times.status_led_us);
+    buf[13] = (uint8_t)usb_watchdog_reset_reason();
+    put_u32_le(&buf[14], usb_watchdog_reboots());
+    vendor_reply(buf, sizeof(buf));
+}
+
+// ================= BENCHMARK DOS EIXOS =================
+// Resposta: [0x49][iterações][µs escalar][µs interp] (u32 LE)[1 = mesmo resultado]
+#define AXIS_BENCH_ITERATIONS 4096   // Uma varredura do ADC por caminho: a fila de comandos para pouco
+
+static void send_axis_bench(void) {
+    axis_bench_t bench;
+    uint8_t buf[14];
+    
+    axis_math_bench(AXIS_BENCH_ITERATIONS, &bench);
+    LOG("axis: %d samples, scalar %d us, interp %d us", bench.iterations,
+        bench.scalar_us, bench.interp_us);
+    
+    buf[0] = CMD_AXIS_BENCH;
+    put_u32_le(&buf[1], bench.iterations);
+    put_u32_le(&buf[5], bench.scalar_us);
+    put_u32_le(&buf[9], bench.interp_us);
+    buf[13] = bench.match ? 1 : 0;
+    vendor_reply(buf, sizeof(buf));
+}
+
+// ================= ATUALIZAÇÃO DE FIRMWARE =================
+// Resposta: [0x4A][status][tamanho do slot u32 LE]
+static void fw_begin(const uint8_t *data, uint16_t len) {
+    uint8_t buf[6];
+    fw_status_t status = FW_ERR_SIZE;
+    
+    // Instalação já agendada: não recomeça por cima da imagem verificada
+    if (soft_timer_active(&update_timer)) {
+        status = FW_ERR_STATE;
+    } else if (len >= 9) {
+        status = fw_update_begin(get_u32_le(&data[1]), get_u32_le(&data[5]));
+    }
+    buf[0] = CMD_FW_BEGIN;
+    buf[1] = (uint8_t)status;
+    put_u32_le(&buf[2], PICO_MOUSE_FW_UPDATE ? FW_UPDATE_SLOT_SIZE : 0);
+    vendor_reply(buf, sizeof(buf));
+}
+
+// Resposta: [0x4B][status][próximo offset esperado u32 LE]. Um setor novo
+// apaga na hora (~50 ms, bloqueia o laço): o host mantém poucos blocos em voo
+// e, com FW_ERR_OFFSET, retoma do offset da resposta.
+static void fw_data(const uint8_t *data, uint16_t len) {
+    uint8_t buf[6];
+    fw_status_t status = FW_ERR_SIZE;
+    
+    if (len > 5) {
+        status = fw_update_data(get_u32_le(&data[1]), &data[5], len - 5u);
+    }
+    buf[0] = CMD_FW_DATA;
+    buf[1] = (uint8_t)status;
+    put_u32_le(&buf[2], fw_update_received());
+    vendor_reply(buf, sizeof(buf));
+}
+
+// Resposta: [0x4C][status]. Com a imagem conferida, a instalação roda no
+// update_task() depois de FW_INSTALL_DELAY_MS, com a resposta já entregue.
+static void fw_commit(void) {
+    uint8_t buf[2];
+    fw_status_t status = fw_update_verify();
+    
+    buf[0] = CMD_FW_COMMIT;
+    buf[1] = (uint8_t)status;
+    vendor_reply(buf, sizeof(buf));
+    
+    if (status == FW_OK) {
+        soft_timer_start_oneshot(&update_timer, FW_INSTALL_DELAY_MS * 1000);
+    }
+}
+
+void update_task(void) {
+    if (!soft_timer_expired(&update_timer)) return;
+    
+    // Fora do barramento e com as configurações pendentes gravadas: a cópia
+    // leva alguns segundos com tudo parado e termina num reset
+    tud_disconnect();
+    usb_connected = false;
+    flash_store_flush();
+    usb_watchdog_prepare_reboot(RESET_REASON_UPDATE);
+    fw_update_install();
+    
+    // A instalação não começou: a flash continua com este firmware
+    usb_watchdog_pause(false);
+    tud_connect();
+}
+
+// ================= GERADOR DE CARGA =================
+// Resposta: [0x4D][padrão ativo][gerados][recusados, fila cheia][µs]
+// [pulados, gerador atrasado] (u32 LE). Com padrão 0 para o gerador; a
+// resposta traz o total da última rodada.
+static void load_command(const uint8_t *data, uint16_t len) {
+    uint8_t buf[18];
+    load_gen_stats_t stats;
+    
+    if (len < 2 || data[1] == LOAD_OFF) {
+        load_gen_stop();
+    } else if (len >= 4) {
+        uint32_t rate_hz = (uint32_t)(data[2] | (data[3] << 8));
+        uint32_t duration_ms = len >= 5 && data[4] > 0 ? data[4] * 1000u : LOAD_GEN_DURATION_DEFAULT_MS;
+        load_gen_start((load_pattern_t)data[1], rate_hz, duration_ms, len >= 6 ? data[5] : 0);
+    }
+#if !PICO_MOUSE_FREERTOS
+    // O alarme só acorda o laço do WFE; a agenda é do load_gen_next()
+    if (load_gen_pattern() != LOAD_OFF) {
+        soft_timer_start_periodic(&load_timer, MAX(load_gen_period_us(), LOAD_TICK_MIN_US));
+    }
+#endif
+    
+    load_gen_get_stats(&stats);
+    buf[0] = CMD_LOAD_GEN;
+    buf[1] = (uint8_t)load_gen_pattern();
+    put_u32_le(&buf[2], stats.generated);
+    put_u32_le(&buf[6], stats.ring_full);
+    put_u32_le(&buf[10], stats.elapsed_us);
+    put_u32_le(&buf[14], stats.skipped);
+    vendor_reply(buf, sizeof(buf));
+}
+
+// Põe na fila os eventos sintéticos vencidos, com o instante em que entraram.
+// Os de telemetria levam também a última deflexão dos eixos, a ocupação da
+// fila e os recusados até ali (saturado em 16 bits).
+void load_task(void) {
+    uint32_t now = time_us_32();
+    uint32_t seq;
+    uint8_t data[15];
+    
+    for (int i = 0; i < LOAD_GEN_MAX_PER_PASS && load_gen_next(now, &seq); i++) {
+        uint8_t type = EVENT_LOAD_GEN;
+        uint8_t len = 8;
+        put_u32_le(&data[0], seq);
+        put_u32_le(&data[4], now);
+        
+        if (load_gen_is_telemetry(seq)) {
+            load_gen_stats_t stats;
+            load_gen_get_stats(&stats);
+            put_u16_le(&data[8], (uint16_t)axis_last_x);
+            put_u16_le(&data[10], (uint16_t)axis_last_y);
+            data[12] = (uint8_t)event_depth();
+            put_u16_le(&data[13], (uint16_t)MIN(stats.ring_full, 0xFFFFu));
+            type = EVENT_LOAD_TELEMETRY;
+            len = sizeof(data);
+        }
+        if (!event_push(type, data, len)) {
+            load_gen_refused();
+        }
+    }
+    if (soft_timer_active(&load_timer)) {
+        soft_timer_expired(&load_timer);
+        if (load_gen_pattern() == LOAD_OFF) soft_timer_stop(&load_timer);
     }
 }
 
 // ================= LED STATUS (ONBOARD) =================
+// No Pico W o LED onboard fica no chip wireless e a inicialização carrega o
+// firmware dele (centenas de ms, BOARD_CAP_LED_SLOW_INIT). Nesse caso ela sai
+// do boot: só acontece depois do primeiro relatório (ou de STATUS_LED_INIT_MS
+// sem host). Até lá set_status_led() só guarda o estado pedido.
+static bool status_led_ready = false;
+static bool status_led_attempted = false;
+static bool status_led_state = false;
+
 void set_status_led(bool on) {
-    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, on);
+    status_led_state = on;
+    if (status_led_ready) {
+        board_status_led_put(on);
+    }
 }
 
-void blink_status_led(int times, int delay_ms) {
-    for (int i = 0; i < times; i++) {
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
-        sleep_ms(delay_ms);
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
-        sleep_ms(delay_ms);
+static void status_led_init(void) {
+    status_led_attempted = true;
+    if (!(board_caps() & BOARD_CAP_STATUS_LED)) return;
+    
+    __unused uint32_t t_start = time_us_32();
+    if (!board_status_led_init()) {
+        // Sem LED onboard o mouse continua funcionando
+        LOG("status led: init failed (board caps 0x%x)", board_caps());
+        return;
     }
+    boot_times.status_led_us = time_us_32();
+    status_led_ready = true;
+    board_status_led_put(status_led_state);
+    LOG("status led: ready in %d us", boot_times.status_led_us - t_start);
+}
+
+void status_led_task(void) {
+    if (status_led_attempted) return;
+    if (boot_times.first_report_us == 0 && time_us_32() < STATUS_LED_INIT_MS * 1000) return;
+    status_led_init();
 }
 
 // ================= CALLBACKS USB =================
 void tud_mount_cb(void) { 
     usb_connected = true;
-    set_rgb_color(0, 255, 0);
+    usb_stats_local()->mounts++;
+    event_channel = CHANNEL_VENDOR;
+    if (boot_times.mount_us == 0) {
+        boot_times.mount_us = time_us_32();
+    }
+    tud_sof_cb_enable(true);
+    wheel_hires = false;
+    wheel_accum = 0;
+    motion_x = 0;
+    motion_y = 0;
+    hid_idle_rate = 0;
+    report_state_len = 0;
+    set_rgb_color(host_color[0], host_color[1], host_color[2]);
     set_status_led(true);
+    LOG("usb: mounted (mode %d)", usb_get_report_mode());
 }
 
 void tud_umount_cb(void) { 
     usb_connected = false;
+    usb_suspended = false;
     set_rgb_color(255, 0, 0);
     set_status_led(false);
+    LOG("usb: unmounted");
+}
+
+// Só sinaliza: a troca de clocks acontece no power_task(), fora do tud_task()
+void tud_suspend_cb(bool remote_wakeup_en) {
+    remote_wakeup_allowed = remote_wakeup_en;
+    usb_suspended = true;
+    usb_stats_local()->suspends++;
+    LOG("usb: suspend (remote wakeup %d)", remote_wakeup_en);
+}
+
+void tud_resume_cb(void) {
+    usb_suspended = false;
+    LOG("usb: resume");
+}
+
+// Só chamado com o barramento ativo (habilitado no mount)
+void tud_sof_cb(uint32_t frame_count) {
+    (void)frame_count;
+    usb_stats_local()->sof++;
 }
 
 void tud_vendor_rx_cb(uint8_t itf, uint8_t const* buffer, uint16_t bufsize) {
     (void)itf;
+    usb_stats_local()->vendor_rx_bytes += bufsize;
     if (bufsize > 0) {
-        handle_led_command(buffer[0], buffer, bufsize);
+        command_push(CHANNEL_VENDOR, 0, buffer, bufsize);
     }
 }
 
 // ================= CALLBACKS HID =================
+static uint8_t current_report_format(uint8_t *report_id);
+
 uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id, 
                                hid_report_type_t report_type, 
                                uint8_t* buffer, uint16_t reqlen) {
-    (void)instance; (void)report_id; (void)report_type; (void)buffer; (void)reqlen;
+    (void)instance;
+    
+    if (report_id == REPORT_ID_MOUSE && report_type == HID_REPORT_TYPE_FEATURE &&
+        reqlen >= sizeof(hid_mouse_feature_report_t)) {
+        buffer[0] = wheel_hires ? 1 : 0;
+        return sizeof(hid_mouse_feature_report_t);
+    }
+    
+    // Estado e resposta do último comando recebido por SET_FEATURE (com
+    // FEATURE_PENDING o host lê de novo)
+    if (report_id == REPORT_ID_VENDOR && report_type == HID_REPORT_TYPE_FEATURE && reqlen > 0) {
+        uint16_t len = MIN(reqlen, HID_VENDOR_REPORT_SIZE);
+        memset(buffer, 0, len);
+        uint32_t save = save_and_disable_interrupts();
+        buffer[0] = hid_feature_status;
+        if ((hid_feature_status & 0x03) == FEATURE_READY) {
+            memcpy(&buffer[1], hid_feature_reply, MIN(len - 1, hid_feature_reply_len));
+        }
+        restore_interrupts(save);
+        return len;
+    }
+    
+    // Relatório de entrada pelo endpoint de controle: botões/posição atuais,
+    // sem movimento relativo (já entregue pelo endpoint de interrupção)
+    if (report_type == HID_REPORT_TYPE_INPUT) {
+        uint8_t expected_id;
+        uint8_t len = current_report_format(&expected_id);
+        if (report_id != expected_id || reqlen < len) return 0;
+        
+        if (report_state_len == len && report_state_id == expected_id) {
+            memcpy(buffer, report_state, len);
+        } else {
+            memset(buffer, 0, len);
+        }
+        return len;
+    }
     return 0;
 }
 
 void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, 
                            hid_report_type_t report_type, 
                            uint8_t const* buffer, uint16_t bufsize) {
-    (void)instance; (void)report_id; (void)report_type; (void)buffer; (void)bufsize;
+    (void)instance;
+    
+    // Host habilita a roda de alta resolução escrevendo o Resolution Multiplier
+    if (report_id == REPORT_ID_MOUSE && report_type == HID_REPORT_TYPE_FEATURE &&
+        bufsize >= sizeof(hid_mouse_feature_report_t)) {
+        wheel_hires = (buffer[0] & 0x03) != 0;
+        wheel_accum = 0;
+    }
+    
+    // Comando vendor pelo hidraw (HIDIOCSFEATURE), mesmo formato da interface vendor
+    if (report_id == REPORT_ID_VENDOR && report_type == HID_REPORT_TYPE_FEATURE &&
+        bufsize > 0) {
+        usb_stats_local()->vendor_rx_bytes += bufsize;
+        uint32_t save = save_and_disable_interrupts();
+        hid_feature_seq = (hid_feature_seq + 1) & 0x3F;
+        hid_feature_status = FEATURE_STATUS(hid_feature_seq, FEATURE_PENDING);
+        restore_interrupts(save);
+        if (!command_push(CHANNEL_HID, hid_feature_seq, buffer, bufsize)) {
+            hid_feature_status = FEATURE_STATUS(hid_feature_seq, FEATURE_DROPPED);
+        }
+    }
+}
+
+void tud_hid_set_protocol_cb(uint8_t instance, uint8_t protocol) {
+    (void)instance; (void)protocol;
+    // A troca de protocolo reinicia o estado do multiplicador (HID 1.11 / HUT)
+    wheel_hires = false;
+    wheel_accum = 0;
+    report_state_len = 0;   // Formato mudou: o próximo relatório sai sempre
+}
+
+// O TinyUSB guarda a taxa e responde o GET_IDLE; aqui ela passa a valer
+// para a supressão de relatórios sem mudança
+bool tud_hid_set_idle_cb(uint8_t instance, uint8_t idle_rate) {
+    (void)instance;
+    hid_idle_rate = idle_rate;
+    return true;
 }
 
 // ================= CALIBRAÇÃO =================
+// O centro salvo na flash vale desde o boot. Sem ele (ou após
+// CMD_RECALIBRATE) cada amostragem soma uma leitura até CAL_SAMPLES, sem
+// bloquear o laço; o mouse só reporta depois disso.
+static uint32_t cal_sum_x = 0;
+static uint32_t cal_sum_y = 0;
+static uint8_t cal_count = 0;
+static calibration_t range_seen;    // Extremos vistos na captura de faixa
+
+static void calibration_apply(void) {
+    axis_norm_build(&norm_x, calibration.center_x, calibration.min_x, calibration.max_x);
+    axis_norm_build(&norm_y, calibration.center_y, calibration.min_y, calibration.max_y);
+}
+
+static void calibration_save(void) {
+    calibration_apply();
+    flash_store_set(STORE_KEY_CALIBRATION, &calibration, sizeof(calibration));
+}
+
 void calibrate_joystick(void) {
-    if (calibrated) return;
+    calibrated = false;
+    cal_sum_x = 0;
+    cal_sum_y = 0;
+    cal_count = 0;
+}
+
+static void calibrate_step(void) {
+    adc_select_input(0);
+    cal_sum_x += adc_read();
+    adc_select_input(1);
+    cal_sum_y += adc_read();
+    if (++cal_count < CAL_SAMPLES) return;
     
-    uint32_t sum_x = 0, sum_y = 0;
-    const int samples = 50;
+    // Os batentes capturados antes continuam valendo
+    calibration.center_x = cal_sum_x / CAL_SAMPLES;
+    calibration.center_y = cal_sum_y / CAL_SAMPLES;
+    calibration_save();
+    calibrated = true;
+    LOG("joystick: calibrated center x=%d y=%d", calibration.center_x, calibration.center_y);
+    
+    led_flash(0, 255, 255, 200);    // Flash RGB Ciano: calibração concluída
+}
+
+// Captura de faixa: durante `duration_ms` o usuário leva o joystick aos
+// batentes; cada amostra só atualiza os extremos e o cursor fica parado.
+// No fim, um lado com menos de CAL_RANGE_MIN_SPAN contagens descarta tudo.
+void calibrate_range_start(uint32_t duration_ms) {
+    range_seen.min_x = ADC_MAX;
+    range_seen.max_x = 0;
+    range_seen.min_y = ADC_MAX;
+    range_seen.max_y = 0;
+    soft_timer_start_oneshot(&range_timer, duration_ms * 1000);
+    range_capture = true;
+    LOG("joystick: range capture for %d ms", duration_ms);
+}
+
+static bool range_side_ok(uint16_t center, uint16_t min, uint16_t max) {
+    return center - min >= CAL_RANGE_MIN_SPAN && max - center >= CAL_RANGE_MIN_SPAN;
+}
+
+static void range_step(void) {
+    adc_select_input(0);
+    uint16_t x_raw = adc_read();
+    adc_select_input(1);
+    uint16_t y_raw = adc_read();
     
-    blink_status_led(3, 100);
+    range_seen.min_x = MIN(range_seen.min_x, x_raw);
+    range_seen.max_x = MAX(range_seen.max_x, x_raw);
+    range_seen.min_y = MIN(range_seen.min_y, y_raw);
+    range_seen.max_y = MAX(range_seen.max_y, y_raw);
+    if (!soft_timer_expired(&range_timer)) return;
     
-    for (int i = 0; i < samples; i++) {
-        adc_select_input(0);
-        sum_x += adc_read();
-        adc_select_input(1);
-        sum_y += adc_read();
-        sleep_ms(20);
+    range_capture = false;
+    if (!range_side_ok(calibration.center_x, range_seen.min_x, range_seen.max_x) ||
+        !range_side_ok(calibration.center_y, range_seen.min_y, range_seen.max_y)) {
+        LOG("joystick: range rejected, x=%d..%d", range_seen.min_x, range_seen.max_x);
+        LOG("joystick: range rejected, y=%d..%d", range_seen.min_y, range_seen.max_y);
+        led_flash(255, 0, 0, 200);      // Flash RGB Vermelho: faixa descartada
+        return;
     }
     
-    center_x = sum_x / samples;
-    center_y = sum_y / samples;
-    calibrated = true;
+    calibration.min_x = range_seen.min_x;
+    calibration.max_x = range_seen.max_x;
+    calibration.min_y = range_seen.min_y;
+    calibration.max_y = range_seen.max_y;
+    calibration_save();
+    LOG("joystick: range x=%d..%d", calibration.min_x, calibration.max_x);
+    LOG("joystick: range y=%d..%d", calibration.min_y, calibration.max_y);
     
-    blink_status_led(5, 50);
+    led_flash(0, 255, 255, 200);    // Flash RGB Ciano: calibração concluída
 }
 
-// ================= MOUSE TASK =================
-void mouse_task(void) {
-    static uint32_t last_read = 0;
-    uint32_t now = to_ms_since_boot(get_absolute_time());
+// ================= RELATÓRIO HID =================
+static int32_t HOT_PATH_FUNC(clamp_i32)(int32_t v, int32_t limit) {
+    if (v > limit) return limit;
+    if (v < -limit) return -limit;
+    return v;
+}
+
+// Parte do acumulador da roda (em 1/120 detent) que cabe num relatório,
+// na unidade que o host espera
+static int32_t HOT_PATH_FUNC(wheel_chunk)(bool hires, int32_t limit) {
+    if (hires) return clamp_i32(wheel_accum, limit);
+    return clamp_i32(wheel_accum / WHEEL_RESOLUTION_MULTIPLIER, limit);
+}
+
+// Desconta dos acumuladores só o que o relatório aceito pelo TinyUSB levou
+static void HOT_PATH_FUNC(motion_consume)(int32_t x, int32_t y, bool hires, int32_t wheel) {
+    motion_x -= x;
+    motion_y -= y;
+    wheel_accum -= hires ? wheel : wheel * WHEEL_RESOLUTION_MULTIPLIER;
+}
+
+// Report ID e tamanho do relatório de entrada no modo/protocolo atuais
+static uint8_t current_report_format(uint8_t *report_id) {
+    if (usb_get_report_mode() == REPORT_MODE_ABSOLUTE) {
+        *report_id = REPORT_ID_MOUSE;
+        return sizeof(hid_mouse_abs_report_t);
+    }
+    if (tud_hid_get_protocol() == HID_PROTOCOL_BOOT) {
+        *report_id = 0;
+        return 4;
+    }
+    *report_id = REPORT_ID_MOUSE;
+    return sizeof(hid_mouse_hires_report_t);
+}
+
+// Envia só se o relatório difere do estado atual (ou a taxa de idle venceu).
+// `state` é o mesmo relatório com os campos relativos zerados.
+static bool HOT_PATH_FUNC(report_submit)(uint8_t report_id, const void *report,
+                                         const void *state, uint8_t len) {
+    uint32_t now = time_us_32();
+    bool changed = report_state_len != len || report_state_id != report_id ||
+                   memcmp(report, report_state, len) != 0;
+    bool idle_due = hid_idle_rate != 0 &&
+                    now - last_report_us >= (uint32_t)hid_idle_rate * 4000;
+    
+    if (!changed && !idle_due) {
+        usb_stats_local()->reports_suppressed++;
+        return false;
+    }
+    if (!tud_hid_report(report_id, report, len)) {
+        usb_stats_local()->reports_failed++;
+        return false;
+    }
+    usb_stats_local()->reports_sent++;
+    if (boot_times.first_report_us == 0) {
+        boot_times.first_report_us = now;
+        LOG("boot: first report at %d us", now);
+    }
+    
+    memcpy(report_state, state, len);
+    report_state_len = len;
+    report_state_id = report_id;
+    last_report_us = now;
+    return true;
+}
+
+// Envia o estado mais recente dos botões e o que couber do movimento
+// acumulado; o resto fica para o próximo relatório
+static void HOT_PATH_FUNC(mouse_flush)(void) {
+    if (!usb_connected || usb_suspended || !calibrated) return;
+    if (!tud_hid_ready()) {
+        usb_stats_local()->hid_busy++;
+        return;
+    }
+    
+    uint8_t buttons = report_buttons;
     
-    if (now - last_read < 1000/POLLING_RATE) return;
-    last_read = now;
+    if (usb_get_report_mode() == REPORT_MODE_ABSOLUTE) {
+        // Cursor integrado no dispositivo: o host recebe a posição final
+        int32_t wheel = wheel_chunk(false, MAX_SPEED);
+        hid_mouse_abs_report_t report = {
+            .buttons = buttons,
+            .x = (uint16_t)abs_x,
+            .y = (uint16_t)abs_y,
+            .wheel = (int8_t)wheel,
+        };
+        hid_mouse_abs_report_t state = report;
+        state.wheel = 0;
+        if (report_submit(REPORT_ID_MOUSE, &report, &state, sizeof(report))) {
+            motion_consume(0, 0, false, wheel);
+        }
+        return;
+    }
+    
+    if (tud_hid_get_protocol() == HID_PROTOCOL_BOOT) {
+        // Protocolo boot (BIOS): 8 bits, sem report ID, roda em detents
+        int32_t x = clamp_i32(motion_x, MAX_SPEED);
+        int32_t y = clamp_i32(motion_y, MAX_SPEED);
+        int32_t wheel = wheel_chunk(false, MAX_SPEED);
+        uint8_t report[4] = {
+            buttons,
+            (uint8_t)(int8_t)x,
+            (uint8_t)(int8_t)y,
+            (uint8_t)(int8_t)wheel
+        };
+        uint8_t state[4] = { buttons, 0, 0, 0 };
+        if (report_submit(0, report, state, sizeof(report))) {
+            motion_consume(x, y, false, wheel);
+        }
+        return;
+    }
     
-    if (!usb_connected || !tud_hid_ready()) return;
+    bool hires = wheel_hires;
+    int32_t x = clamp_i32(motion_x, MAX_SPEED_HIRES);
+    int32_t y = clamp_i32(motion_y, MAX_SPEED_HIRES);
+    int32_t wheel = wheel_chunk(hires, MAX_SPEED_HIRES);
+    hid_mouse_hires_report_t report = {
+        .buttons = buttons,
+        .x = (int16_t)x,
+        .y = (int16_t)y,
+        .wheel = (int16_t)wheel,
+    };
+    hid_mouse_hires_report_t state = { .buttons = buttons };
+    if (report_submit(REPORT_ID_MOUSE, &report, &state, sizeof(report))) {
+        motion_consume(x, y, hires, wheel);
+    }
+}
+
+// ================= MOUSE TASK =================
+void hid_delay_record(uint32_t delay_us) {
+    usb_stats_t *stats = usb_stats_local();
+    if (delay_us > stats->hid_delay_max_us) stats->hid_delay_max_us = delay_us;
+}
+
+void HOT_PATH_FUNC(mouse_task)(void) {
+    if (soft_timer_expired(&mouse_timer)) {
+        hid_delay_record(time_us_32() - mouse_timer.fired_us);
+        mouse_sample_and_report();
+    } else {
+        // Entre amostras: entrega o restante assim que o endpoint liberar
+        mouse_flush();
+    }
+}
+
+// Uma amostra do joystick/botões somada aos acumuladores, e um relatório HID
+// se o endpoint estiver livre. Com o endpoint ocupado nada se perde: o
+// movimento continua acumulando até o próximo relatório.
+void HOT_PATH_FUNC(mouse_sample_and_report)(void) {
+    if (usb_suspended) return;
     
+    // Calibra já antes da enumeração: o primeiro relatório sai logo no mount
     if (!calibrated) {
-        calibrate_joystick();
+        calibrate_step();
+        return;
+    }
+    if (range_capture) {
+        range_step();
         return;
     }
+    if (!usb_connected) return;
+    
+    uint32_t t_start = time_us_32();
     
     // Ler joystick
     adc_select_input(0);
@@ -211,70 +1310,54 @@ void mouse_task(void) {
     adc_select_input(1);
     uint16_t y_raw = adc_read();
     
-    int32_t x_diff = (int32_t)x_raw - (int32_t)center_x;
-    int32_t y_diff = (int32_t)y_raw - (int32_t)center_y;
+    // Deadzone, sensibilidade e predição trabalham na faixa normalizada
+    int32_t x_diff = axis_normalize(&norm_x, x_raw);
+    int32_t y_diff = axis_normalize(&norm_y, y_raw);
+    axis_last_x = (int16_t)x_diff;
+    axis_last_y = (int16_t)y_diff;
     
-    int8_t x_move = 0;
-    int8_t y_move = 0;
+    int32_t deadzone = tuning.deadzone;
+    int32_t sensitivity = tuning.sensitivity;
     
-    if (x_diff < -DEADZONE) {
-        x_move = (x_diff + DEADZONE) / SENSITIVITY;
-    } else if (x_diff > DEADZONE) {
-        x_move = (x_diff - DEADZONE) / SENSITIVITY;
-    }
+#if PICO_MOUSE_PREDICT
+    // Deflexão projetada PREDICT_HORIZON_US à frente; perto do repouso passa crua
+    uint32_t dt_us = t_start - predict_last_us;
+    predict_last_us = t_start;
+    x_diff = predictor_step(&predict_x, x_diff, dt_us, deadzone + PREDICT_REST_MARGIN);
+    y_diff = predictor_step(&predict_y, y_diff, dt_us, deadzone + PREDICT_REST_MARGIN);
+#endif
     
-    if (y_diff < -DEADZONE) {
-        y_move = (y_diff + DEADZONE) / SENSITIVITY;
-    } else if (y_diff > DEADZONE) {
-        y_move = (y_diff - DEADZONE) / SENSITIVITY;
-    }
+    int32_t x_move = axis_deadzone(x_diff, deadzone) / sensitivity;
+    int32_t y_move = axis_deadzone(y_diff, deadzone) / sensitivity;
     
-    if (x_move > MAX_SPEED) x_move = MAX_SPEED;
-    if (x_move < -MAX_SPEED) x_move = -MAX_SPEED;
-    if (y_move > MAX_SPEED) y_move = MAX_SPEED;
-    if (y_move < -MAX_SPEED) y_move = -MAX_SPEED;
+    // Clique que acordou o host: conta como pressionado nesta amostra mesmo
+    // se o botão já foi solto (a soltura sai na amostra seguinte)
+    uint8_t replay = wake_buttons;
+    wake_buttons = 0;
     
     // Ler botões
-    bool btn_left = !gpio_get(BUTTON_LEFT_PIN);    // Botão A = Esquerdo
-    bool btn_right = !gpio_get(BUTTON_RIGHT_PIN);  // Botão B = Direito
-    bool btn_mid = !gpio_get(BUTTON_MIDDLE_PIN);   // Joystick = Meio
+    bool btn_left = !gpio_get(BUTTON_LEFT_PIN) || (replay & 0x01);     // Botão A = Esquerdo
+    bool btn_right = !gpio_get(BUTTON_RIGHT_PIN) || (replay & 0x02);   // Botão B = Direito
+    bool btn_mid = !gpio_get(BUTTON_MIDDLE_PIN) || (replay & 0x04);    // Joystick = Meio
     
     // Detectar eventos e piscar LED
     if (btn_left && !btn_left_prev) {
         event_push(EVENT_BTN_LEFT_PRESS, NULL, 0);
-        // Piscar LED Onboard - Botão Esquerdo
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
-        // Flash RGB Vermelho
-        set_rgb_color(255, 0, 0);
-        sleep_us(50000); // 50ms
-        set_rgb_color(0, 255, 0);
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
+        led_flash(255, 0, 0, 50);       // Flash RGB Vermelho
     } else if (!btn_left && btn_left_prev) {
         event_push(EVENT_BTN_LEFT_RELEASE, NULL, 0);
     }
     
     if (btn_right && !btn_right_prev) {
         event_push(EVENT_BTN_RIGHT_PRESS, NULL, 0);
-        // Piscar LED Onboard - Botão Direito
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
-        // Flash RGB Azul
-        set_rgb_color(0, 0, 255);
-        sleep_us(50000); // 50ms
-        set_rgb_color(0, 255, 0);
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
+        led_flash(0, 0, 255, 50);       // Flash RGB Azul
     } else if (!btn_right && btn_right_prev) {
         event_push(EVENT_BTN_RIGHT_RELEASE, NULL, 0);
     }
     
     if (btn_mid && !btn_mid_prev) {
         event_push(EVENT_BTN_MID_PRESS, NULL, 0);
-        // Piscar LED Onboard - Botão Meio (mais longo)
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
-        // Flash RGB Branco
-        set_rgb_color(255, 255, 255);
-        sleep_us(100000); // 100ms
-        set_rgb_color(0, 255, 0);
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
+        led_flash(255, 255, 255, 100);  // Flash RGB Branco (mais longo)
     } else if (!btn_mid && btn_mid_prev) {
         event_push(EVENT_BTN_MID_RELEASE, NULL, 0);
     }
@@ -286,54 +1369,393 @@ void mouse_task(void) {
     uint8_t buttons = 0;
     if (btn_left) buttons |= 0x01;  // Botão A = Esquerdo
     if (btn_right) buttons |= 0x02; // Botão B = Direito
+    
+#if SCROLL_ON_MIDDLE
+    // Botão do meio vira modificador: eixo Y rola em vez de mover o cursor
+    if (btn_mid) {
+        wheel_accum -= y_move * SCROLL_SPEED;
+        x_move = 0;
+        y_move = 0;
+    }
+#else
     if (btn_mid) buttons |= 0x04;   // Joystick = Meio
+#endif
+    
+    // Entrada ativa volta o governador à taxa máxima já nesta amostra
+    bool active = x_move != 0 || y_move != 0 || btn_left || btn_right || btn_mid;
+    if (governor_update(active)) {
+#if !PICO_MOUSE_FREERTOS
+        soft_timer_start_periodic(&mouse_timer, governor_period_us());
+#endif
+        LOG("governor: level %d (%d Hz)", governor_level(), 1000000 / governor_period_us());
+    }
+    
+    // Absoluto integra a cada amostra; relativo acumula até ser enviado
+    if (usb_get_report_mode() == REPORT_MODE_ABSOLUTE) {
+        abs_x += x_move * ABS_GAIN;
+        abs_y += y_move * ABS_GAIN;
+        if (abs_x < 0) abs_x = 0;
+        if (abs_x > ABS_COORD_MAX) abs_x = ABS_COORD_MAX;
+        if (abs_y < 0) abs_y = 0;
+        if (abs_y > ABS_COORD_MAX) abs_y = ABS_COORD_MAX;
+    } else {
+        motion_x = clamp_i32(motion_x + x_move, MOTION_ACCUM_MAX);
+        motion_y = clamp_i32(motion_y + y_move, MOTION_ACCUM_MAX);
+    }
+    wheel_accum = clamp_i32(wheel_accum, MOTION_ACCUM_MAX);
+    report_buttons = buttons;
     
-    uint8_t report[4] = {buttons, (uint8_t)x_move, (uint8_t)y_move, 0};
-    tud_hid_report(0, report, sizeof(report));
+    mouse_flush();
+    
+    uint32_t elapsed = time_us_32() - t_start;
+    hot_samples++;
+    hot_total_us += elapsed;
+    if (elapsed > hot_max_us) hot_max_us = elapsed;
 }
 
 // ================= VENDOR TASK =================
-void vendor_task(void) {
-    if (!tud_vendor_mounted() || !tud_vendor_write_available()) return;
-    
+// Os eventos saem em lote: [tipo][dados] um atrás do outro até encher o
+// pacote, e o tamanho de cada um segue do tipo (o host separa). Só tira da
+// fila um evento quando o maior possível ainda cabe, sem espiar a fila.
+#define VENDOR_PACKET_SIZE 64
+
+static uint16_t HOT_PATH_FUNC(event_batch)(uint8_t *buf, uint16_t size, uint32_t *count) {
+    uint16_t used = 0;
     vendor_event_t event;
-    if (event_pop(&event)) {
-        uint8_t buf[4];
-        buf[0] = event.type;
-        memcpy(&buf[1], event.data, event.len);
-        
-        tud_vendor_write(buf, event.len + 1);
+    
+    *count = 0;
+    while (used + 1 + EVENT_DATA_MAX <= size && event_pop(&event)) {
+        buf[used] = event.type;
+        memcpy(&buf[used + 1], event.data, event.len);
+        used += 1 + event.len;
+        (*count)++;
+    }
+    return used;
+}
+
+// Lote como relatório de entrada REPORT_ID_VENDOR (tipo 0 = fim do lote). Só
+// sai com o endpoint HID livre: o mouse_task() roda antes no laço e o
+// relatório do mouse tem prioridade; os eventos esperam na fila pelo próximo
+// intervalo.
+static void HOT_PATH_FUNC(vendor_hid_event)(void) {
+    if (!usb_connected || usb_suspended) return;
+    if (tud_hid_get_protocol() != HID_PROTOCOL_REPORT || !tud_hid_ready()) return;
+    
+    uint8_t buf[HID_VENDOR_REPORT_SIZE] = {0};
+    uint32_t count;
+    uint16_t len = event_batch(buf, sizeof(buf), &count);
+    if (len == 0) return;
+    
+    if (tud_hid_report(REPORT_ID_VENDOR, buf, sizeof(buf))) {
+        usb_stats_local()->vendor_tx_bytes += len;
+    } else {
+        usb_stats_local()->events_dropped += count;
+    }
+}
+
+void HOT_PATH_FUNC(vendor_task)(void) {
+    if (event_channel == CHANNEL_HID) {
+        if (event_pending()) vendor_hid_event();
+        return;
+    }
+    if (!tud_vendor_mounted() || !event_pending()) return;
+    
+    uint8_t buf[VENDOR_PACKET_SIZE];
+    uint32_t available = tud_vendor_write_available();
+    if (available < 1 + EVENT_DATA_MAX) {
+        usb_stats_local()->vendor_tx_full++;
+        return;
+    }
+    
+    uint32_t count;
+    uint16_t len = event_batch(buf, (uint16_t)MIN(available, sizeof(buf)), &count);
+    if (len > 0) {
+        usb_stats_local()->vendor_tx_bytes += tud_vendor_write(buf, len);
         tud_vendor_flush();
     }
 }
 
+// ================= COMANDOS VENDOR =================
+// Executa comandos da fila por até COMMAND_BUDGET_US; o primeiro sempre roda
+// (um comando não é interrompido). No bare-metal uma amostra do mouse vencida
+// encerra a passada antes do próximo comando: o relatório HID sai primeiro.
+// Na variante FreeRTOS a entrada tem o core 1 só para ela.
+static bool HOT_PATH_FUNC(hid_sample_due)(void) {
+#if PICO_MOUSE_FREERTOS
+    return false;
+#else
+    return soft_timer_due(&mouse_timer);
+#endif
+}
+
+void command_task(void) {
+    uint32_t start = time_us_32();
+    vendor_command_t cmd;
+    
+    do {
+        if (!command_pop(&cmd)) return;
+        command_channel = (vendor_channel_t)cmd.channel;
+        command_seq = cmd.seq;
+        handle_vendor_command(cmd.data, cmd.len);
+        command_channel = CHANNEL_VENDOR;
+        
+        // Sem vendor_reply(): o host para de esperar pelo GET_FEATURE
+        uint32_t save = save_and_disable_interrupts();
+        if (cmd.channel == CHANNEL_HID &&
+            hid_feature_status == FEATURE_STATUS(cmd.seq, FEATURE_PENDING)) {
+            hid_feature_status = FEATURE_STATUS(cmd.seq, FEATURE_NO_REPLY);
+        }
+        restore_interrupts(save);
+    } while (time_us_32() - start < COMMAND_BUDGET_US && !hid_sample_due());
+    
+    uint32_t elapsed = time_us_32() - start;
+    if (elapsed > COMMAND_BUDGET_US) {
+        LOG("vendor: commands took %d us (last 0x%02x)", elapsed, cmd.data[0]);
+    }
+}
+
+// ================= TROCA DE MODO USB =================
+void report_mode_task(void) {
+    static bool detached = false;
+    
+    if (!detached) {
+        if (!mode_switch_pending) return;
+        mode_switch_pending = false;
+        if (mode_switch_target == usb_get_report_mode()) return;
+        
+        // Sai do barramento antes de gravar a flash e trocar os descritores
+        tud_disconnect();
+        usb_connected = false;
+        uint8_t mode = mode_switch_target;
+        flash_store_set(STORE_KEY_REPORT_MODE, &mode, sizeof(mode));
+        flash_store_flush();
+        usb_set_report_mode((report_mode_t)mode);
+        LOG("usb: switching to report mode %d", mode);
+        soft_timer_start_oneshot(&reenum_timer, REENUM_DELAY_MS * 1000);
+        detached = true;
+    } else if (soft_timer_expired(&reenum_timer)) {
+        detached = false;
+        tud_connect();
+    }
+}
+
+// ================= SUPERVISOR USB =================
+void usb_supervisor_task(void) {
+    // SOF e montagens só são contados no contexto do tud_task(), no core 0
+    const usb_stats_t *stats = &usb_stats_core[0];
+    if (usb_watchdog_task(usb_connected && !usb_suspended, stats->sof, stats->mounts)) {
+        // Fora do barramento até o próximo tud_mount_cb()
+        usb_connected = false;
+        usb_stats_local()->stall_reconnects++;
+    }
+}
+
+// ================= BAIXO CONSUMO (USB SUSPEND) =================
+static const uint led_pins[3] = {LED_RED_PIN, LED_GREEN_PIN, LED_BLUE_PIN};
+static __unused uint32_t saved_sys_khz = 0;
+
+static void timers_start(void) {
+#if !PICO_MOUSE_FREERTOS
+    // Na variante FreeRTOS a tarefa de entrada usa vTaskDelayUntil
+    soft_timer_start_periodic(&mouse_timer, governor_period_us());
+#endif
+    soft_timer_start_periodic(&heartbeat_timer, HEARTBEAT_MS * 1000);
+}
+
+static void timers_stop(void) {
+    soft_timer_stop(&mouse_timer);
+    soft_timer_stop(&heartbeat_timer);
+}
+
+// ================= REMOTE WAKEUP =================
+static void wake_gpio_callback(uint gpio, uint32_t events) {
+    (void)events;
+    if (gpio == BUTTON_LEFT_PIN) wake_buttons |= 0x01;
+    if (gpio == BUTTON_RIGHT_PIN) wake_buttons |= 0x02;
+    if (gpio == BUTTON_MIDDLE_PIN) wake_buttons |= 0x04;
+    wake_request = true;
+}
+
+static void wake_watch(bool enable) {
+    // Pull-up: apertar o botão é a borda de descida
+    gpio_set_irq_enabled_with_callback(BUTTON_LEFT_PIN, GPIO_IRQ_EDGE_FALL, enable, wake_gpio_callback);
+    gpio_set_irq_enabled(BUTTON_RIGHT_PIN, GPIO_IRQ_EDGE_FALL, enable);
+    gpio_set_irq_enabled(BUTTON_MIDDLE_PIN, GPIO_IRQ_EDGE_FALL, enable);
+    
+    if (enable) {
+        soft_timer_start_periodic(&wake_poll_timer, WAKE_POLL_MS * 1000);
+    } else {
+        soft_timer_stop(&wake_poll_timer);
+    }
+}
+
+static bool joystick_deflected(void) {
+    if (!calibrated) return false;
+    
+    adc_select_input(0);
+    int32_t x_diff = axis_normalize(&norm_x, adc_read());
+    adc_select_input(1);
+    int32_t y_diff = axis_normalize(&norm_y, adc_read());
+    
+    int32_t deadzone = tuning.deadzone;
+    return axis_deadzone(x_diff, deadzone) != 0 || axis_deadzone(y_diff, deadzone) != 0;
+}
+
+// Suspenso com remote wakeup habilitado: qualquer clique ou movimento acorda
+// o host; o clique é repetido no primeiro relatório após o resume
+static void wake_task(void) {
+    if (soft_timer_expired(&wake_poll_timer) && joystick_deflected()) {
+        wake_request = true;
+    }
+    if (!wake_request) return;
+    
+    wake_request = false;
+    if (tud_remote_wakeup()) {
+        usb_stats_local()->remote_wakeups++;
+        LOG("usb: remote wakeup (buttons 0x%x)", wake_buttons);
+    }
+}
+
+static void low_power_enter(void) {
+    wake_buttons = 0;
+    wake_request = false;
+    
+    // LED RGB: PWM parado e pinos em nível alto (apagado, ânodo comum)
+    for (int i = 0; i < 3; i++) {
+        pwm_set_enabled(pwm_gpio_to_slice_num(led_pins[i]), false);
+        gpio_init(led_pins[i]);
+        gpio_set_dir(led_pins[i], GPIO_OUT);
+        gpio_put(led_pins[i], 1);
+    }
+    set_status_led(false);
+    
+    if (remote_wakeup_allowed) {
+        // Entrada continua vigiada: botões por IRQ de GPIO, joystick pelo ADC
+        // a cada WAKE_POLL_MS (o ADC fica ligado)
+        wake_watch(true);
+    } else {
+        // ADC desligado e sem clock
+        hw_clear_bits(&adc_hw->cs, ADC_CS_EN_BITS);
+        clock_stop(clk_adc);
+    }
+    
+#if PICO_MOUSE_SUSPEND_CLOCKS && !PICO_MOUSE_FREERTOS
+    // clk_sys passa a vir do PLL USB (48 MHz) e o PLL do sistema é desligado.
+    // No FreeRTOS o SysTick vem do clk_sys, então o clock não é alterado.
+    saved_sys_khz = clock_get_hz(clk_sys) / KHZ;
+    set_sys_clock_48mhz();
+#endif
+    
+    // Sem alarmes periódicos o WFI só acorda com o resume ou GPIO
+    timers_stop();
+    usb_watchdog_pause(true);
+    low_power = true;
+}
+
+static void low_power_exit(void) {
+    wake_watch(false);
+    
+#if PICO_MOUSE_SUSPEND_CLOCKS && !PICO_MOUSE_FREERTOS
+    set_sys_clock_khz(saved_sys_khz, true);
+#endif
+    
+    clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB,
+                    48 * MHZ, 48 * MHZ);
+    adc_init();
+    
+    for (int i = 0; i < 3; i++) {
+        gpio_set_function(led_pins[i], GPIO_FUNC_PWM);
+        pwm_set_enabled(pwm_gpio_to_slice_num(led_pins[i]), true);
+    }
+    set_rgb_color(current_color[0], current_color[1], current_color[2]);
+    set_status_led(usb_connected);
+    
+    timers_start();
+    usb_watchdog_pause(false);
+    low_power = false;
+}
+
+void power_task(void) {
+    if (usb_suspended && !low_power) {
+        low_power_enter();
+    } else if (!usb_suspended && low_power) {
+        low_power_exit();
+    } else if (low_power && remote_wakeup_allowed) {
+        wake_task();
+    }
+}
+
+#if !PICO_MOUSE_FREERTOS
+// Espera até a próxima iteração; suspenso, dorme em WFI até uma interrupção
+// (USB resume, GPIO ou alarme do timer). Ativo, o WFE acorda no alarme de
+// qualquer tarefa (ou interrupção USB) e no máximo 1 ms depois.
+static void main_loop_wait(void) {
+    if (command_pending()) return;  // Resto da fila após o orçamento
+    if (low_power) {
+        __wfi();
+    } else {
+        best_effort_wfe_or_timeout(make_timeout_time_ms(1));
+    }
+}
+#endif
+
+// ================= EFEITOS DE LED =================
+void effects_task(void) {
+    led_flash_t req;
+    
+    if (led_flash_take(&req)) {
+        set_status_led(false);
+        set_rgb_color(req.rgb[0], req.rgb[1], req.rgb[2]);
+        soft_timer_start_oneshot(&flash_timer, (uint32_t)req.duration_ms * 1000);
+    } else if (soft_timer_expired(&flash_timer)) {
+        set_rgb_color(host_color[0], host_color[1], host_color[2]);
+        set_status_led(true);
+    }
+}
+
 // ================= LED HEARTBEAT =================
 void heartbeat_task(void) {
-    static uint32_t last_blink = 0;
     static bool led_state = false;
-    uint32_t now = to_ms_since_boot(get_absolute_time());
+    
+    if (!soft_timer_expired(&heartbeat_timer)) return;
     
     if (!usb_connected) {
-        if (now - last_blink > 500) {
-            led_state = !led_state;
-            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, led_state);
-            last_blink = now;
-        }
+        led_state = !led_state;
+        set_status_led(led_state);
     }
 }
 
-// ================= MAIN =================
-int main() {
-    stdio_init_all();
+// ================= ESTADO PERSISTENTE =================
+static void load_persistent_state(void) {
+    uint8_t mode;
+    calibration_v1_t cal_v1;
+    tuning_t stored_tuning;
     
-    if (cyw43_arch_init()) {
-        while(1) tight_loop_contents();
-    }
-    
-    blink_status_led(3, 200);
+    flash_store_init();
     
-    init_rgb_led();
-    set_rgb_color(255, 0, 0);
+    if (flash_store_get(STORE_KEY_REPORT_MODE, &mode, sizeof(mode))) {
+        usb_set_report_mode((report_mode_t)mode);
+    }
+    if (flash_store_get(STORE_KEY_CALIBRATION, &calibration, sizeof(calibration))) {
+        calibrated = true;
+    } else if (flash_store_get(STORE_KEY_CALIBRATION, &cal_v1, sizeof(cal_v1))) {
+        calibration.center_x = cal_v1.center_x;
+        calibration.center_y = cal_v1.center_y;
+        calibrated = true;
+    }
+    calibration_apply();
+    if (flash_store_get(STORE_KEY_TUNING, &stored_tuning, sizeof(stored_tuning)) &&
+        stored_tuning.sensitivity > 0) {
+        tuning = stored_tuning;
+    }
+    flash_store_get(STORE_KEY_LED, host_color, sizeof(host_color));
+}
+
+// ================= INICIALIZAÇÃO =================
+// Só o necessário para enumerar e ler a entrada; um LED onboard lento (cyw43)
+// fica para o status_led_task() e o sinal de boot é o LED RGB vermelho
+static void hardware_init(void) {
+    stdio_init_all();
     
     adc_init();
     adc_gpio_init(JOYSTICK_X_PIN);
@@ -350,16 +1772,51 @@ int main() {
     gpio_init(BUTTON_MIDDLE_PIN);
     gpio_set_dir(BUTTON_MIDDLE_PIN, GPIO_IN);
     gpio_pull_up(BUTTON_MIDDLE_PIN);
+    axis_math_init();
+    
+    load_persistent_state();
+    
+    init_rgb_led();
+    set_rgb_color(255, 0, 0);
+    if (!(board_caps() & BOARD_CAP_LED_SLOW_INIT)) {
+        status_led_init();
+    }
     
+    timer_service_init();
+    governor_init();
+    timers_start();
+    usb_watchdog_init();
+}
+
+// ================= MAIN =================
+int main() {
+    hardware_init();
+    
+#if PICO_MOUSE_FREERTOS
+    // tusb_init() é chamado pela tarefa USB, já com o escalonador rodando
+    app_queues_init();
+    rtos_start();
+#else
     tusb_init();
     
     while (true) {
         tud_task();
+        usb_supervisor_task();
         mouse_task();
+        load_task();
         vendor_task();
+        command_task();
+        report_mode_task();
+        update_task();
+        effects_task();
         heartbeat_task();
-        sleep_ms(1);
+        flash_store_task();
+        cdc_log_task();
+        power_task();
+        status_led_task();
+        main_loop_wait();
     }
+#endif
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,53 @@
+#include "pico/stdlib.h"
+#include "config.h"
+#include "predictor.h"
+#include "hot_path.h"
+
+// Com amostras mais espaçadas que o horizonte o alfa atrasa mais do que a
+// projeção adianta (ver tools/predictor_replay.c): a leitura passa crua
+#define PREDICT_MAX_DT_US  PREDICT_HORIZON_US
+#define PREDICT_VEL_MAX_Q8 (256 << 8) // 256 contagens/ms: acima disso é ruído
+
+_Static_assert(PREDICT_ALPHA > 0 && PREDICT_ALPHA <= 256, "PREDICT_ALPHA: Q8 in 1..256");
+_Static_assert(PREDICT_BETA > 0 && PREDICT_BETA <= 256, "PREDICT_BETA: Q8 in 1..256");
+
+void predictor_reset(predictor_axis_t *axis) {
+    axis->pos_q8 = 0;
+    axis->vel_q8 = 0;
+    axis->tracking = false;
+}
+
+int32_t HOT_PATH_FUNC(predictor_step)(predictor_axis_t *axis, int32_t meas, uint32_t dt_us,
+                                      int32_t rest_limit) {
+    int32_t meas_q8 = meas * 256;
+    
+    if (meas <= rest_limit && meas >= -rest_limit) {
+        predictor_reset(axis);
+        return meas;
+    }
+    if (!axis->tracking || dt_us == 0 || dt_us > PREDICT_MAX_DT_US) {
+        axis->pos_q8 = meas_q8;
+        axis->vel_q8 = 0;
+        axis->tracking = true;
+        return meas;
+    }
+    
+    // Alfa-beta: prevê, mede o resíduo e corrige posição e velocidade
+    int32_t pred_q8 = axis->pos_q8 + (int32_t)((int64_t)axis->vel_q8 * dt_us / 1000);
+    int32_t residual = meas_q8 - pred_q8;
+    axis->pos_q8 = pred_q8 + ((PREDICT_ALPHA * residual) >> 8);
+    int32_t vel = axis->vel_q8 +
+                  (int32_t)((int64_t)((PREDICT_BETA * residual) >> 8) * 1000 / dt_us);
+    if (vel > PREDICT_VEL_MAX_Q8) vel = PREDICT_VEL_MAX_Q8;
+    if (vel < -PREDICT_VEL_MAX_Q8) vel = -PREDICT_VEL_MAX_Q8;
+    axis->vel_q8 = vel;
+    
+    int32_t out = (axis->pos_q8 +
+                   (int32_t)((int64_t)vel * PREDICT_HORIZON_US / 1000)) / 256;
+    
+    // Sem overshoot: a projeção para no centro e não passa do curso do ADC
+    if ((meas > 0 && out < 0) || (meas < 0 && out > 0)) return 0;
+    if (out > 2047) return 2047;
+    if (out < -2047) return -2047;
+    return out;
+}
@@ -0,0 +1,27 @@
+#ifndef PREDICTOR_H_
+#define PREDICTOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Predição de curto prazo da deflexão do joystick (filtro alfa-beta em ponto
+// fixo Q8). Cada amostra atualiza posição e velocidade estimadas e devolve a
+// deflexão projetada PREDICT_HORIZON_US à frente, compensando parte da
+// latência entre o movimento do stick e o cursor. Perto do repouso o estado é
+// zerado e a leitura passa sem predição; a projeção nunca cruza o centro, então
+// soltar o stick não gera movimento no sentido oposto.
+
+typedef struct {
+    int32_t pos_q8;     // Deflexão estimada (contagens do ADC, Q8)
+    int32_t vel_q8;     // Contagens por ms, Q8
+    bool tracking;
+} predictor_axis_t;
+
+void predictor_reset(predictor_axis_t *axis);
+
+// `meas` = deflexão em relação ao centro; `dt_us` = tempo desde a amostra
+// anterior; abaixo de `rest_limit` (em módulo) a predição fica desligada
+int32_t predictor_step(predictor_axis_t *axis, int32_t meas, uint32_t dt_us,
+                       int32_t rest_limit);
+
+#endif
@@ -0,0 +1,7 @@
+// Perfil balanced: governador de 1 kHz (com entrada) a 30 Hz (ocioso), com
+// efeitos de LED e economia no suspend.
+#define PICO_MOUSE_PROFILE_NAME   "balanced"
+#define PICO_MOUSE_GOVERNOR       1
+#define HID_POLL_INTERVAL_MS      1
+#define PICO_MOUSE_EFFECTS        1
+#define PICO_MOUSE_SUSPEND_CLOCKS 1
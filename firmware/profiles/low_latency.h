@@ -0,0 +1,8 @@
+// Perfil low_latency: amostragem e endpoint a 1 kHz, caminho quente na SRAM
+// (ligado pelo CMake), sem efeitos de LED e com os clocks intactos no
+// suspend para o resume ser imediato.
+#define PICO_MOUSE_PROFILE_NAME   "low_latency"
+#define POLLING_RATE              1000
+#define HID_POLL_INTERVAL_MS      1
+#define PICO_MOUSE_EFFECTS        0
+#define PICO_MOUSE_SUSPEND_CLOCKS 0
@@ -0,0 +1,9 @@
+// Perfil low_power: governador limitado a 250 Hz com entrada e descendo até
+// 10 Hz ocioso, endpoint consultado a cada 4 ms, sem efeitos de LED e clocks
+// reduzidos no suspend.
+#define PICO_MOUSE_PROFILE_NAME   "low_power"
+#define PICO_MOUSE_GOVERNOR       1
+#define GOVERNOR_LEVELS           { {250, 0}, {60, 250}, {30, 1000}, {10, 5000} }
+#define HID_POLL_INTERVAL_MS      4
+#define PICO_MOUSE_EFFECTS        0
+#define PICO_MOUSE_SUSPEND_CLOCKS 1
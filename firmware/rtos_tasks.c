@@ -0,0 +1,148 @@
+#include "pico/stdlib.h"
+#include "tusb.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_tasks.h"
+#include "flash_store.h"
+#include "cdc_log.h"
+#include "governor.h"
+#include "axis_math.h"
+#include "load_gen.h"
+
+// Variante FreeRTOS SMP: USB e entrada nunca esperam pela telemetria nem
+// pelos efeitos de LED. Core 0 fica com USB/telemetria/efeitos (o cyw43 do Pico W
+// e o TinyUSB vivem nele); o core 1 é só da leitura do joystick.
+
+#define USB_TASK_PRIORITY       (configMAX_PRIORITIES - 1)
+#define INPUT_TASK_PRIORITY     (configMAX_PRIORITIES - 2)
+#define TELEMETRY_TASK_PRIORITY (tskIDLE_PRIORITY + 2)
+#define EFFECTS_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+
+// Em palavras. A telemetria executa os comandos vendor: o caminho mais fundo
+// é o CMD_FW_DATA (comando copiado da fila + flash_safe_execute() + ROM) e o
+// CMD_GET_RATE_STATS (buffers na pilha), perto de 1 KB; o dobro dá folga.
+// A menor folga de cada tarefa sai no log (stack_watch()).
+#define USB_TASK_STACK          1024
+#define INPUT_TASK_STACK        512
+#define TELEMETRY_TASK_STACK    512
+#define EFFECTS_TASK_STACK      512
+
+#define EFFECTS_PERIOD_MS       5
+#define STACK_WATCH_MS          1000
+
+#define CORE0 (1u << 0)
+#define CORE1 (1u << 1)
+
+// Tarefas na ordem de criação (índice usado no log de pilha)
+#define TASK_COUNT 4
+static TaskHandle_t task_handles[TASK_COUNT];
+static UBaseType_t task_stack_min[TASK_COUNT];
+
+// ================= PILHAS =================
+// Menor folga já vista de cada pilha (uxTaskGetStackHighWaterMark, em
+// palavras); loga só quando diminui. 0 = usb, 1 = input, 2 = telemetry,
+// 3 = effects.
+static void stack_watch(void) {
+    static TickType_t last = 0;
+    TickType_t now = xTaskGetTickCount();
+    
+    if (now - last < pdMS_TO_TICKS(STACK_WATCH_MS)) return;
+    last = now;
+    for (int i = 0; i < TASK_COUNT; i++) {
+        UBaseType_t free_words = uxTaskGetStackHighWaterMark(task_handles[i]);
+        if (free_words < task_stack_min[i]) {
+            task_stack_min[i] = free_words;
+            LOG("rtos: task %d stack low-water %d words free", i, free_words);
+        }
+    }
+}
+
+// Estouro detectado na troca de contexto (configCHECK_FOR_STACK_OVERFLOW)
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name) {
+    (void)task;
+    panic("rtos: stack overflow in task %s", name);
+}
+
+// ================= TAREFAS =================
+static void usb_task(void *param) {
+    (void)param;
+    tusb_init();
+    
+    while (true) {
+        // Bloqueia na fila de eventos do TinyUSB até a próxima interrupção
+        tud_task();
+    }
+}
+
+static void input_task(void *param) {
+    (void)param;
+    TickType_t last_wake = xTaskGetTickCount();
+    
+    // O interpolador é por core: o do core 0 já foi configurado no boot
+    axis_math_init();
+    
+    while (true) {
+        // Período do nível atual do governador (1 tick no mínimo)
+        TickType_t period = pdMS_TO_TICKS(governor_period_us() / 1000);
+        vTaskDelayUntil(&last_wake, period ? period : 1);
+        hid_delay_record((xTaskGetTickCount() - last_wake) * portTICK_PERIOD_MS * 1000);
+        mouse_sample_and_report();
+    }
+}
+
+static void telemetry_task(void *param) {
+    (void)param;
+    
+    while (true) {
+        // Acorda com evento ou comando na fila; o timeout cobre o endpoint
+        // ocupado e, com o gerador de carga ativo, a agenda dele (1 tick)
+        event_wait(load_gen_pattern() != LOAD_OFF ? 1 : EFFECTS_PERIOD_MS);
+        load_task();
+        vendor_task();
+        command_task();
+    }
+}
+
+static void effects_system_task(void *param) {
+    (void)param;
+    
+    while (true) {
+        usb_supervisor_task();
+        effects_task();
+        heartbeat_task();
+        report_mode_task();
+        update_task();
+        flash_store_task();
+        cdc_log_task();
+        power_task();
+        status_led_task();
+        stack_watch();
+        vTaskDelay(pdMS_TO_TICKS(EFFECTS_PERIOD_MS));
+    }
+}
+
+// ================= INICIALIZAÇÃO =================
+static void create_task(TaskFunction_t fn, const char *name, uint32_t stack,
+                        UBaseType_t priority, UBaseType_t core_mask) {
+    static int count = 0;
+    TaskHandle_t handle;
+    if (xTaskCreate(fn, name, stack, NULL, priority, &handle) != pdPASS) {
+        panic("rtos: failed to create task %s", name);
+    }
+    vTaskCoreAffinitySet(handle, core_mask);
+    task_handles[count] = handle;
+    task_stack_min[count] = stack;
+    count++;
+}
+
+void rtos_start(void) {
+    create_task(usb_task, "usb", USB_TASK_STACK, USB_TASK_PRIORITY, CORE0);
+    create_task(input_task, "input", INPUT_TASK_STACK, INPUT_TASK_PRIORITY, CORE1);
+    create_task(telemetry_task, "telemetry", TELEMETRY_TASK_STACK, TELEMETRY_TASK_PRIORITY, CORE0);
+    create_task(effects_system_task, "effects", EFFECTS_TASK_STACK, EFFECTS_TASK_PRIORITY, CORE0);
+    
+    vTaskStartScheduler();
+    
+    // Só chega aqui se faltar heap para a tarefa ociosa/timer
+    panic("rtos: scheduler exited");
+}
@@ -0,0 +1,81 @@
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+#include "timer_service.h"
+#include "hot_path.h"
+
+static alarm_pool_t *pool;
+static critical_section_t timer_lock;   // IRQ do alarme x tarefas (e o outro core)
+
+void timer_service_init(void) {
+    pool = alarm_pool_get_default();
+    critical_section_init(&timer_lock);
+}
+
+static int64_t HOT_PATH_FUNC(soft_timer_alarm)(alarm_id_t id, void *user_data) {
+    soft_timer_t *timer = (soft_timer_t *)user_data;
+    (void)id;
+    
+    critical_section_enter_blocking(&timer_lock);
+    timer->pending++;
+    timer->fired_us = time_us_32();
+    critical_section_exit(&timer_lock);
+    __sev();    // Acorda um laço parado em WFE
+    
+    if (timer->period_us == 0) {
+        timer->active = false;
+        return 0;
+    }
+    // Negativo: reagenda relativo ao instante previsto anterior (sem deriva)
+    return -(int64_t)timer->period_us;
+}
+
+static bool soft_timer_start(soft_timer_t *timer, uint32_t delay_us, uint32_t period_us) {
+    soft_timer_stop(timer);
+    timer->period_us = period_us;
+    timer->active = true;
+    
+    alarm_id_t id = alarm_pool_add_alarm_in_us(pool, delay_us, soft_timer_alarm, timer, true);
+    if (id <= 0) {
+        timer->active = false;
+        return false;
+    }
+    timer->alarm = id;
+    return true;
+}
+
+bool soft_timer_start_periodic(soft_timer_t *timer, uint32_t period_us) {
+    if (period_us == 0) return false;
+    return soft_timer_start(timer, period_us, period_us);
+}
+
+bool soft_timer_start_oneshot(soft_timer_t *timer, uint32_t delay_us) {
+    return soft_timer_start(timer, delay_us, 0);
+}
+
+void soft_timer_stop(soft_timer_t *timer) {
+    if (timer->alarm > 0) {
+        alarm_pool_cancel_alarm(pool, timer->alarm);
+        timer->alarm = 0;
+    }
+    critical_section_enter_blocking(&timer_lock);
+    timer->active = false;
+    timer->pending = 0;
+    critical_section_exit(&timer_lock);
+}
+
+bool soft_timer_active(const soft_timer_t *timer) {
+    return timer->active;
+}
+
+bool HOT_PATH_FUNC(soft_timer_expired)(soft_timer_t *timer) {
+    if (timer->pending == 0) return false;
+    
+    critical_section_enter_blocking(&timer_lock);
+    timer->pending = 0;
+    critical_section_exit(&timer_lock);
+    return true;
+}
+
+bool HOT_PATH_FUNC(soft_timer_due)(const soft_timer_t *timer) {
+    return timer->pending != 0;
+}
@@ -0,0 +1,33 @@
+#ifndef TIMER_SERVICE_H_
+#define TIMER_SERVICE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/time.h"
+
+// Temporizadores de software sobre o alarm pool padrão do SDK (resolução de
+// microssegundos). O alarme só conta o disparo na IRQ; a tarefa consome com
+// soft_timer_expired() no laço principal. Os periódicos são reagendados a
+// partir do instante previsto anterior, então o atraso não se acumula.
+typedef struct {
+    volatile uint32_t pending;  // Disparos ainda não consumidos
+    volatile uint32_t fired_us; // time_us_32() do último disparo
+    uint32_t period_us;         // 0 = disparo único
+    alarm_id_t alarm;
+    volatile bool active;
+} soft_timer_t;
+
+void timer_service_init(void);
+bool soft_timer_start_periodic(soft_timer_t *timer, uint32_t period_us);
+bool soft_timer_start_oneshot(soft_timer_t *timer, uint32_t delay_us);
+void soft_timer_stop(soft_timer_t *timer);
+bool soft_timer_active(const soft_timer_t *timer);
+
+// true se disparou desde a última consulta; disparos perdidos são
+// descartados em vez de executados em rajada
+bool soft_timer_expired(soft_timer_t *timer);
+
+// Como soft_timer_expired(), mas sem consumir o disparo
+bool soft_timer_due(const soft_timer_t *timer);
+
+#endif
@@ -0,0 +1,7 @@
+// Substituto mínimo do SDK para compilar módulos puros (predictor.c) no host
+#ifndef HOST_PICO_PLATFORM_H_
+#define HOST_PICO_PLATFORM_H_
+
+#define __not_in_flash_func(f) f
+
+#endif
@@ -0,0 +1,9 @@
+// Substituto mínimo do SDK para compilar módulos puros (predictor.c) no host
+#ifndef HOST_PICO_STDLIB_H_
+#define HOST_PICO_STDLIB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#endif
@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+"""Relatório de uso de flash/RAM a partir do mapa do linker (.elf.map).
+
+Gera um detalhamento por objeto e por símbolo, mostra as reservas de
+heap/pilha e compara o total com um arquivo de orçamento. Sai com código 1
+quando flash ou RAM passam do orçamento (+ tolerância) e quando o mapa não é
+de um link completo (sem main() ou sem __flash_binary_end): um mapa parcial
+daria totais pequenos demais e o orçamento nunca falharia. Com o orçamento
+ainda não medido só avisa.
+
+Uso:
+    memory_report.py <arquivo.map> [--budget arquivo] [--report saida.txt]
+                     [--update] [--top N]
+"""
+
+import argparse
+import os
+import re
+import sys
+from collections import defaultdict
+
+FLASH_BASE = 0x10000000
+RAM_BASE = 0x20000000
+RAM_END = 0x20042000
+
+# Seções que são reservas (não código/dados): listadas à parte
+RESERVE_SECTIONS = {
+    ".heap": "heap",
+    ".stack_dummy": "stack core0",
+    ".stack1_dummy": "stack core1",
+}
+
+# Seções de RAM sem imagem na flash (zeradas ou não inicializadas)
+NOLOAD_SECTIONS = {".bss", ".tbss", ".uninitialized_data"}
+
+OUT_SECTION_RE = re.compile(
+    r"^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?")
+OUT_SECTION_NAME_RE = re.compile(r"^(\.\S+)\s*$")
+OUT_SECTION_CONT_RE = re.compile(
+    r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?\s*$")
+IN_SECTION_RE = re.compile(r"^ (\.\S+|COMMON|\*fill\*)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*)$")
+IN_SECTION_NAME_RE = re.compile(r"^ (\.\S+|COMMON)\s*$")
+IN_SECTION_CONT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+SYMBOL_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+(?:PROVIDE \()?(\w+)(?: = .*)?")
+
+SYMBOL_PREFIXES = (".text.", ".time_critical.", ".rodata.", ".data.", ".bss.",
+                   ".sram.text.", ".scratch_x.", ".scratch_y.", ".uninitialized_data.")
+
+
+def short_object(path):
+    path = path.strip()
+    if not path:
+        return "(linker)"
+    m = re.match(r"(.*?)([^/]+\.a)\((.*)\)$", path)
+    if m:
+        return "%s(%s)" % (m.group(2), m.group(3))
+    return os.path.basename(path)
+
+
+def section_symbol(name):
+    for prefix in SYMBOL_PREFIXES:
+        if name.startswith(prefix):
+            return name[len(prefix):]
+    return None
+
+
+def region_of(addr):
+    if FLASH_BASE <= addr < RAM_BASE:
+        return "flash"
+    if RAM_BASE <= addr < RAM_END:
+        return "ram"
+    return None
+
+
+class MapInfo:
+    def __init__(self):
+        self.flash_end = None
+        self.has_main = False
+        self.sections = []                       # (nome, vma, tamanho, lma)
+        self.objects = defaultdict(lambda: defaultdict(int))
+        self.symbols = defaultdict(lambda: defaultdict(int))
+        self.reserves = defaultdict(int)
+
+    def add_input(self, out, name, addr, size, obj):
+        if out is None or size == 0:
+            return
+        out_name, vma, _, lma = out
+        region = region_of(vma)
+        if region is None:
+            return
+        if out_name in RESERVE_SECTIONS:
+            self.reserves[RESERVE_SECTIONS[out_name]] += size
+            return
+
+        obj = short_object(obj) if name != "*fill*" else "(fill)"
+        regions = [region]
+        if (region == "ram" and out_name not in NOLOAD_SECTIONS and
+                lma is not None and region_of(lma) == "flash"):
+            regions.append("flash")     # Imagem de inicialização copiada no boot
+        for r in regions:
+            self.objects[obj][r] += size
+            sym = section_symbol(name) if name != "*fill*" else None
+            self.symbols[(sym or name, obj)][r] += size
+
+
+def parse_map(path):
+    info = MapInfo()
+    with open(path, errors="replace") as f:
+        lines = f.read().splitlines()
+
+    try:
+        start = lines.index("Linker script and memory map") + 1
+    except ValueError:
+        sys.exit("memory_report: '%s' is not a GNU ld map file" % path)
+
+    out = None
+    pending_out = None
+    pending_in = None
+    for line in lines[start:]:
+        if pending_out:
+            m = OUT_SECTION_CONT_RE.match(line)
+            if m:
+                lma = int(m.group(3), 16) if m.group(3) else None
+                out = (pending_out, int(m.group(1), 16), int(m.group(2), 16), lma)
+                info.sections.append(out)
+            else:
+                out = None
+            pending_out = None
+            continue
+        if pending_in:
+            m = IN_SECTION_CONT_RE.match(line)
+            if m:
+                info.add_input(out, pending_in, int(m.group(1), 16), int(m.group(2), 16), m.group(3))
+            pending_in = None
+            continue
+
+        m = OUT_SECTION_RE.match(line)
+        if m:
+            lma = int(m.group(4), 16) if m.group(4) else None
+            out = (m.group(1), int(m.group(2), 16), int(m.group(3), 16), lma)
+            info.sections.append(out)
+            continue
+        m = OUT_SECTION_NAME_RE.match(line)
+        if m:
+            pending_out = m.group(1)
+            continue
+        m = IN_SECTION_RE.match(line)
+        if m:
+            info.add_input(out, m.group(1), int(m.group(2), 16), int(m.group(3), 16), m.group(4))
+            continue
+        m = IN_SECTION_NAME_RE.match(line)
+        if m:
+            pending_in = m.group(1)
+            continue
+        m = SYMBOL_RE.match(line)
+        if m and m.group(2) == "__flash_binary_end":
+            info.flash_end = int(m.group(1), 16)
+        elif m and m.group(2) == "main":
+            info.has_main = True
+
+    if any(sym == "main" for sym, _ in info.symbols):
+        info.has_main = True
+    return info
+
+
+def check_complete(info, path):
+    missing = []
+    if not info.has_main:
+        missing.append("main()")
+    if info.flash_end is None:
+        missing.append("__flash_binary_end")
+    if missing:
+        sys.exit("memory_report: '%s' is not a complete link (missing %s)"
+                 % (path, ", ".join(missing)))
+
+
+def totals(info):
+    flash = 0
+    ram = 0
+    for name, vma, size, lma in info.sections:
+        region = region_of(vma)
+        if region == "flash":
+            flash = max(flash, vma + size - FLASH_BASE)
+        elif region == "ram" and name not in RESERVE_SECTIONS:
+            ram += size
+            if name not in NOLOAD_SECTIONS and lma is not None and region_of(lma) == "flash":
+                flash = max(flash, lma + size - FLASH_BASE)
+    if info.flash_end is not None:
+        flash = info.flash_end - FLASH_BASE
+    return flash, ram
+
+
+def read_budget(path):
+    budget = {"tolerance_percent": 0}
+    with open(path) as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            key, value = line.split()
+            budget[key] = int(value, 0)
+    return budget
+
+
+def write_budget(path, flash, ram, tolerance):
+    with open(path, "w") as f:
+        f.write("# Orçamento de memória do firmware (bytes).\n")
+        f.write("# O build falha se flash ou RAM estática passarem de valor + tolerância.\n")
+        f.write("# Atualize com: cmake --build . --target memory_budget_update\n")
+        f.write("flash %d\n" % flash)
+        f.write("ram %d\n" % ram)
+        f.write("tolerance_percent %d\n" % tolerance)
+
+
+def format_report(info, flash, ram, top):
+    out = []
+    out.append("Flash (imagem):        %8d bytes" % flash)
+    out.append("RAM (estática):        %8d bytes" % ram)
+    for name in ("heap", "stack core0", "stack core1"):
+        out.append("Reserva %-13s %8d bytes" % (name + ":", info.reserves.get(name, 0)))
+
+    for region in ("flash", "ram"):
+        out.append("")
+        out.append("Top %d objetos (%s):" % (top, region))
+        objs = sorted(info.objects.items(), key=lambda kv: -kv[1].get(region, 0))
+        for obj, sizes in objs[:top]:
+            if sizes.get(region, 0) == 0:
+                break
+            out.append("  %8d  %s" % (sizes[region], obj))
+
+        out.append("")
+        out.append("Top %d símbolos (%s):" % (top, region))
+        syms = sorted(info.symbols.items(), key=lambda kv: -kv[1].get(region, 0))
+        for (sym, obj), sizes in syms[:top]:
+            if sizes.get(region, 0) == 0:
+                break
+            out.append("  %8d  %-40s %s" % (sizes[region], sym, obj))
+    return "\n".join(out) + "\n"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("map")
+    ap.add_argument("--budget", help="arquivo de orçamento (flash/ram/tolerance_percent)")
+    ap.add_argument("--report", help="grava o relatório completo neste arquivo")
+    ap.add_argument("--update", action="store_true", help="reescreve o orçamento com o uso atual")
+    ap.add_argument("--top", type=int, default=15)
+    args = ap.parse_args()
+
+    info = parse_map(args.map)
+    check_complete(info, args.map)
+    flash, ram = totals(info)
+
+    if args.report:
+        with open(args.report, "w") as f:
+            f.write(format_report(info, flash, ram, 1000000))
+    print(format_report(info, flash, ram, args.top), end="")
+
+    if not args.budget:
+        return 0
+
+    if args.update:
+        tolerance = read_budget(args.budget).get("tolerance_percent", 2) if os.path.exists(args.budget) else 2
+        write_budget(args.budget, flash, ram, tolerance)
+        print("\nOrçamento atualizado em %s" % args.budget)
+        return 0
+
+    budget = read_budget(args.budget)
+    # Ainda não medido: o relatório sai, mas um checkout novo não quebra o build
+    if "flash" not in budget or "ram" not in budget:
+        print("memory_report: warning: %s has no measured budget yet; run the "
+              "memory_budget_update target and commit the result" % args.budget, file=sys.stderr)
+        return 0
+    tol = budget.get("tolerance_percent", 0)
+    failed = False
+    print("")
+    for name, used in (("flash", flash), ("ram", ram)):
+        limit = budget[name] + budget[name] * tol // 100
+        status = "OK" if used <= limit else "EXCEDIDO"
+        print("Orçamento %-5s %8d / %8d bytes (base %d + %d%%)  %s"
+              % (name + ":", used, limit, budget[name], tol, status))
+        failed |= used > limit
+
+    if failed:
+        print("memory_report: firmware passou do orçamento em %s" % args.budget, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -24,8 +24,13 @@ extern "C" {
 #define CFG_TUD_HID 1
 #define CFG_TUD_VENDOR 1
 
+// CDC opcional, só para o log de depuração (cmake -DPICO_MOUSE_CDC_LOG=ON)
+#ifndef PICO_MOUSE_CDC_LOG
+#define PICO_MOUSE_CDC_LOG 0
+#endif
+#define CFG_TUD_CDC PICO_MOUSE_CDC_LOG
+
 // Desativar outras classes
-#define CFG_TUD_CDC 0
 #define CFG_TUD_MSC 0
 #define CFG_TUD_MIDI 0
 #define CFG_TUD_AUDIO 0
@@ -35,6 +40,8 @@ extern "C" {
 #define CFG_TUD_HID_EP_BUFSIZE 64
 #define CFG_TUD_VENDOR_RX_BUFSIZE 64
 #define CFG_TUD_VENDOR_TX_BUFSIZE 64
+#define CFG_TUD_CDC_RX_BUFSIZE 64
+#define CFG_TUD_CDC_TX_BUFSIZE 512
 
 #ifdef __cplusplus
 }
@@ -1,15 +1,31 @@
 #include "tusb.h"
+#include "usb_descriptors.h"
+#include "config.h"
 
 #define USB_VID 0xCafe
 #define USB_PID 0x4003
+#define USB_PID_ABSOLUTE 0x4002
+
+static report_mode_t report_mode = REPORT_MODE_RELATIVE;
+
+// Com o CDC de log o dispositivo passa a usar IAD (classe "misc")
+#if PICO_MOUSE_CDC_LOG
+#define DEVICE_CLASS      TUSB_CLASS_MISC
+#define DEVICE_SUBCLASS   MISC_SUBCLASS_COMMON
+#define DEVICE_PROTOCOL   MISC_PROTOCOL_IAD
+#else
+#define DEVICE_CLASS      0x00
+#define DEVICE_SUBCLASS   0x00
+#define DEVICE_PROTOCOL   0x00
+#endif
 
 tusb_desc_device_t const desc_device = {
     .bLength = sizeof(tusb_desc_device_t),
     .bDescriptorType = TUSB_DESC_DEVICE,
     .bcdUSB = 0x0200,
-    .bDeviceClass = 0x00,
-    .bDeviceSubClass = 0x00,
-    .bDeviceProtocol = 0x00,
+    .bDeviceClass = DEVICE_CLASS,
+    .bDeviceSubClass = DEVICE_SUBCLASS,
+    .bDeviceProtocol = DEVICE_PROTOCOL,
     .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
     .idVendor = USB_VID,
     .idProduct = USB_PID,
@@ -20,55 +36,182 @@ tusb_desc_device_t const desc_device = {
     .bNumConfigurations = 0x01
 };
 
+tusb_desc_device_t const desc_device_abs = {
+    .bLength = sizeof(tusb_desc_device_t),
+    .bDescriptorType = TUSB_DESC_DEVICE,
+    .bcdUSB = 0x0200,
+    .bDeviceClass = DEVICE_CLASS,
+    .bDeviceSubClass = DEVICE_SUBCLASS,
+    .bDeviceProtocol = DEVICE_PROTOCOL,
+    .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
+    .idVendor = USB_VID,
+    .idProduct = USB_PID_ABSOLUTE,
+    .bcdDevice = 0x0100,
+    .iManufacturer = 0x01,
+    .iProduct = 0x06,
+    .iSerialNumber = 0x03,
+    .bNumConfigurations = 0x01
+};
+
+// Coleção vendor (0xFF00) acessível pelo hidraw sem driver: o relatório de
+// entrada leva os eventos e o de feature leva os comandos (SET_FEATURE) e a
+// resposta do último comando (GET_FEATURE), no mesmo formato da interface vendor
+#define HID_VENDOR_COLLECTION \
+    HID_USAGE_PAGE_N ( HID_USAGE_PAGE_VENDOR, 2 ), \
+    HID_USAGE        ( 0x01 ), \
+    HID_COLLECTION   ( HID_COLLECTION_APPLICATION ), \
+        HID_REPORT_ID    ( REPORT_ID_VENDOR ) \
+        HID_LOGICAL_MIN  ( 0x00 ), \
+        HID_LOGICAL_MAX_N( 0xff, 2 ), \
+        HID_REPORT_SIZE  ( 8 ), \
+        HID_REPORT_COUNT ( HID_VENDOR_REPORT_SIZE ), \
+        HID_USAGE        ( 0x02 ), \
+        HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ), \
+        HID_USAGE        ( 0x03 ), \
+        HID_FEATURE      ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ), \
+    HID_COLLECTION_END
+
 uint8_t const hid_report_descriptor[] = {
     HID_USAGE_PAGE ( HID_USAGE_PAGE_DESKTOP     ),
     HID_USAGE      ( HID_USAGE_DESKTOP_MOUSE    ),
     HID_COLLECTION ( HID_COLLECTION_APPLICATION ),
-        HID_USAGE_PAGE  ( HID_USAGE_PAGE_BUTTON ),
-        HID_USAGE_MIN   ( 1 ),
-        HID_USAGE_MAX   ( 3 ),
-        HID_LOGICAL_MIN ( 0 ),
-        HID_LOGICAL_MAX ( 1 ),
-        HID_REPORT_COUNT( 3 ),
-        HID_REPORT_SIZE ( 1 ),
-        HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),
-        HID_REPORT_COUNT( 1 ),
-        HID_REPORT_SIZE ( 5 ),
-        HID_INPUT       ( HID_CONSTANT ),
-        HID_USAGE_PAGE  ( HID_USAGE_PAGE_DESKTOP ),
-        HID_USAGE       ( HID_USAGE_DESKTOP_X ),
-        HID_USAGE       ( HID_USAGE_DESKTOP_Y ),
-        HID_LOGICAL_MIN ( 0x81 ),
-        HID_LOGICAL_MAX ( 0x7f ),
-        HID_REPORT_COUNT( 2 ),
-        HID_REPORT_SIZE ( 8 ),
-        HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_RELATIVE ),
-        HID_USAGE       ( HID_USAGE_DESKTOP_WHEEL ),
-        HID_LOGICAL_MIN ( 0x81 ),
-        HID_LOGICAL_MAX ( 0x7f ),
-        HID_REPORT_COUNT( 1 ),
-        HID_REPORT_SIZE ( 8 ),
-        HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_RELATIVE ),
-    HID_COLLECTION_END
+        HID_REPORT_ID   ( REPORT_ID_MOUSE )
+        HID_USAGE       ( HID_USAGE_DESKTOP_POINTER ),
+        HID_COLLECTION  ( HID_COLLECTION_PHYSICAL ),
+            HID_USAGE_PAGE  ( HID_USAGE_PAGE_BUTTON ),
+            HID_USAGE_MIN   ( 1 ),
+            HID_USAGE_MAX   ( 3 ),
+            HID_LOGICAL_MIN ( 0 ),
+            HID_LOGICAL_MAX ( 1 ),
+            HID_REPORT_COUNT( 3 ),
+            HID_REPORT_SIZE ( 1 ),
+            HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),
+            HID_REPORT_COUNT( 1 ),
+            HID_REPORT_SIZE ( 5 ),
+            HID_INPUT       ( HID_CONSTANT ),
+            // X/Y relativos de 16 bits
+            HID_USAGE_PAGE  ( HID_USAGE_PAGE_DESKTOP ),
+            HID_USAGE       ( HID_USAGE_DESKTOP_X ),
+            HID_USAGE       ( HID_USAGE_DESKTOP_Y ),
+            HID_LOGICAL_MIN_N ( 0x8001, 2 ),
+            HID_LOGICAL_MAX_N ( 0x7fff, 2 ),
+            HID_REPORT_COUNT( 2 ),
+            HID_REPORT_SIZE ( 16 ),
+            HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_RELATIVE ),
+            // Roda de alta resolução (Resolution Multiplier + Wheel)
+            HID_COLLECTION  ( HID_COLLECTION_LOGICAL ),
+                HID_USAGE        ( HID_USAGE_DESKTOP_RESOLUTION_MULTIPLIER ),
+                HID_LOGICAL_MIN  ( 0 ),
+                HID_LOGICAL_MAX  ( 1 ),
+                HID_PHYSICAL_MIN ( 1 ),
+                HID_PHYSICAL_MAX ( WHEEL_RESOLUTION_MULTIPLIER ),
+                HID_REPORT_COUNT ( 1 ),
+                HID_REPORT_SIZE  ( 2 ),
+                HID_FEATURE      ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),
+                HID_REPORT_SIZE  ( 6 ),
+                HID_FEATURE      ( HID_CONSTANT ),
+                HID_USAGE        ( HID_USAGE_DESKTOP_WHEEL ),
+                HID_PHYSICAL_MIN ( 0 ),
+                HID_PHYSICAL_MAX ( 0 ),
+                HID_LOGICAL_MIN_N ( 0x8001, 2 ),
+                HID_LOGICAL_MAX_N ( 0x7fff, 2 ),
+                HID_REPORT_SIZE  ( 16 ),
+                HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_RELATIVE ),
+            HID_COLLECTION_END,
+        HID_COLLECTION_END,
+    HID_COLLECTION_END,
+    HID_VENDOR_COLLECTION
 };
 
+uint8_t const hid_report_descriptor_abs[] = {
+    HID_USAGE_PAGE ( HID_USAGE_PAGE_DESKTOP     ),
+    HID_USAGE      ( HID_USAGE_DESKTOP_MOUSE    ),
+    HID_COLLECTION ( HID_COLLECTION_APPLICATION ),
+        HID_REPORT_ID   ( REPORT_ID_MOUSE )
+        HID_USAGE       ( HID_USAGE_DESKTOP_POINTER ),
+        HID_COLLECTION  ( HID_COLLECTION_PHYSICAL ),
+            HID_USAGE_PAGE  ( HID_USAGE_PAGE_BUTTON ),
+            HID_USAGE_MIN   ( 1 ),
+            HID_USAGE_MAX   ( 3 ),
+            HID_LOGICAL_MIN ( 0 ),
+            HID_LOGICAL_MAX ( 1 ),
+            HID_REPORT_COUNT( 3 ),
+            HID_REPORT_SIZE ( 1 ),
+            HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),
+            HID_REPORT_COUNT( 1 ),
+            HID_REPORT_SIZE ( 5 ),
+            HID_INPUT       ( HID_CONSTANT ),
+            // X/Y absolutos de 16 bits
+            HID_USAGE_PAGE  ( HID_USAGE_PAGE_DESKTOP ),
+            HID_USAGE       ( HID_USAGE_DESKTOP_X ),
+            HID_USAGE       ( HID_USAGE_DESKTOP_Y ),
+            HID_LOGICAL_MIN ( 0 ),
+            HID_LOGICAL_MAX_N ( ABS_COORD_MAX, 2 ),
+            HID_PHYSICAL_MIN ( 0 ),
+            HID_PHYSICAL_MAX_N ( ABS_COORD_MAX, 2 ),
+            HID_REPORT_COUNT( 2 ),
+            HID_REPORT_SIZE ( 16 ),
+            HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),
+            // Roda relativa em detents
+            HID_USAGE       ( HID_USAGE_DESKTOP_WHEEL ),
+            HID_LOGICAL_MIN ( 0x81 ),
+            HID_LOGICAL_MAX ( 0x7f ),
+            HID_PHYSICAL_MIN ( 0 ),
+            HID_PHYSICAL_MAX ( 0 ),
+            HID_REPORT_COUNT( 1 ),
+            HID_REPORT_SIZE ( 8 ),
+            HID_INPUT       ( HID_DATA | HID_VARIABLE | HID_RELATIVE ),
+        HID_COLLECTION_END,
+    HID_COLLECTION_END,
+    HID_VENDOR_COLLECTION
+};
+
+// O CDC fica depois do vendor: o driver Linux continua na interface 1
 enum {
     ITF_NUM_HID = 0,
     ITF_NUM_VENDOR,
+#if PICO_MOUSE_CDC_LOG
+    ITF_NUM_CDC,
+    ITF_NUM_CDC_DATA,
+#endif
     ITF_NUM_TOTAL
 };
 
 #define EPNUM_HID_IN      0x81
 #define EPNUM_VENDOR_OUT  0x02
 #define EPNUM_VENDOR_IN   0x82
-#define CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + TUD_HID_DESC_LEN + TUD_VENDOR_DESC_LEN)
+#define EPNUM_CDC_NOTIF   0x83
+#define EPNUM_CDC_OUT     0x04
+#define EPNUM_CDC_IN      0x84
+
+#if PICO_MOUSE_CDC_LOG
+#define CDC_DESC_LEN      TUD_CDC_DESC_LEN
+#define CDC_DESCRIPTOR    , TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, 7, EPNUM_CDC_NOTIF, 8, \
+                                               EPNUM_CDC_OUT, EPNUM_CDC_IN, 64)
+#else
+#define CDC_DESC_LEN      0
+#define CDC_DESCRIPTOR
+#endif
+
+#define CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + TUD_HID_DESC_LEN + TUD_VENDOR_DESC_LEN + CDC_DESC_LEN)
 
 uint8_t const desc_configuration[] = {
     TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 
                          TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
     TUD_HID_DESCRIPTOR(ITF_NUM_HID, 4, HID_ITF_PROTOCOL_MOUSE, 
-                      sizeof(hid_report_descriptor), EPNUM_HID_IN, 64, 10),
+                      sizeof(hid_report_descriptor), EPNUM_HID_IN, 64, HID_POLL_INTERVAL_MS),
     TUD_VENDOR_DESCRIPTOR(ITF_NUM_VENDOR, 5, EPNUM_VENDOR_OUT, EPNUM_VENDOR_IN, 64)
+    CDC_DESCRIPTOR
+};
+
+// Modo absoluto: sem boot protocol (BIOS não entende coordenadas absolutas)
+uint8_t const desc_configuration_abs[] = {
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 
+                         TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+    TUD_HID_DESCRIPTOR(ITF_NUM_HID, 4, HID_ITF_PROTOCOL_NONE, 
+                      sizeof(hid_report_descriptor_abs), EPNUM_HID_IN, 64, HID_POLL_INTERVAL_MS),
+    TUD_VENDOR_DESCRIPTOR(ITF_NUM_VENDOR, 5, EPNUM_VENDOR_OUT, EPNUM_VENDOR_IN, 64)
+    CDC_DESCRIPTOR
 };
 
 char const *string_desc_arr[] = {
@@ -78,21 +221,40 @@ char const *string_desc_arr[] = {
     "123456",
     "Mouse HID Interface",
     "LED Control Interface",
+    "Pico Mouse Joystick Absolute",
+    "Debug Log",
 };
 
 static uint16_t _desc_str[32];
 
+void usb_set_report_mode(report_mode_t mode) {
+    if (mode < REPORT_MODE_COUNT) report_mode = mode;
+}
+
+report_mode_t usb_get_report_mode(void) {
+    return report_mode;
+}
+
 uint8_t const *tud_descriptor_device_cb(void) {
+    if (report_mode == REPORT_MODE_ABSOLUTE) {
+        return (uint8_t const *)&desc_device_abs;
+    }
     return (uint8_t const *)&desc_device;
 }
 
 uint8_t const *tud_descriptor_configuration_cb(uint8_t index) {
     (void)index;
+    if (report_mode == REPORT_MODE_ABSOLUTE) {
+        return desc_configuration_abs;
+    }
     return desc_configuration;
 }
 
 uint8_t const *tud_hid_descriptor_report_cb(uint8_t instance) {
     (void)instance;
+    if (report_mode == REPORT_MODE_ABSOLUTE) {
+        return hid_report_descriptor_abs;
+    }
     return hid_report_descriptor;
 }
 
@@ -0,0 +1,53 @@
+#ifndef USB_DESCRIPTORS_H_
+#define USB_DESCRIPTORS_H_
+
+#include <stdint.h>
+#include "tusb.h"
+
+// Report IDs usados no protocolo report (o protocolo boot não usa ID)
+enum {
+    REPORT_ID_MOUSE = 1,
+    REPORT_ID_VENDOR = 2,   // Coleção vendor: eventos (input) e comandos (feature)
+};
+
+// Carga dos relatórios REPORT_ID_VENDOR; com o ID cabe num pacote de 64 bytes
+#define HID_VENDOR_REPORT_SIZE 63
+
+// Personalidade USB apresentada na enumeração
+typedef enum {
+    REPORT_MODE_RELATIVE = 0,   // Mouse relativo com boot protocol (PID 0x4003)
+    REPORT_MODE_ABSOLUTE,       // Mouse absoluto 0..32767 (PID 0x4002)
+    REPORT_MODE_COUNT
+} report_mode_t;
+
+#define ABS_COORD_MAX 32767
+
+// Unidades de roda por "detent" quando o host habilita o Resolution Multiplier
+#define WHEEL_RESOLUTION_MULTIPLIER 120
+
+// Relatório de entrada REPORT_ID_MOUSE (sem o byte de ID)
+typedef struct TU_ATTR_PACKED {
+    uint8_t buttons;
+    int16_t x;
+    int16_t y;
+    int16_t wheel;
+} hid_mouse_hires_report_t;
+
+// Relatório de entrada REPORT_ID_MOUSE no modo absoluto
+typedef struct TU_ATTR_PACKED {
+    uint8_t buttons;
+    uint16_t x;
+    uint16_t y;
+    int8_t wheel;
+} hid_mouse_abs_report_t;
+
+// Relatório de feature REPORT_ID_MOUSE: bit 0..1 = multiplicador da roda
+typedef struct TU_ATTR_PACKED {
+    uint8_t resolution_multiplier;
+} hid_mouse_feature_report_t;
+
+// Só deve ser alterado com o dispositivo desconectado do barramento
+void usb_set_report_mode(report_mode_t mode);
+report_mode_t usb_get_report_mode(void);
+
+#endif
@@ -0,0 +1,174 @@
+#include "pico/stdlib.h"
+#include "hardware/watchdog.h"
+#include "tusb.h"
+#include "usb_watchdog.h"
+#include "cdc_log.h"
+
+#define WD_HW_TIMEOUT_MS     2000   // Acima do cyw43_arch_init() no laço bare-metal
+#define WD_SOF_STALL_MS       100   // Montado, fora do suspend e sem SOF
+#define WD_HID_STALL_MS      2000   // Relatório HID na fila sem o host ler
+#define WD_HID_STALL_MAX_MS 64000   // Teto do recuo com host que não lê o endpoint
+#define WD_RECONNECT_DELAY_MS  20   // Tempo fora do barramento na reconexão
+#define WD_RECOVER_MS        1000   // Prazo para a re-enumeração antes do reboot
+
+// Scratch 0..3 são livres; o SDK usa 4..7 no watchdog_reboot()
+#define WD_SCRATCH_MAGIC    0
+#define WD_SCRATCH_REASON   1
+#define WD_SCRATCH_REBOOTS  2
+#define WD_MAGIC            0x55534257u // "WBSU"
+
+typedef enum {
+    WD_MONITOR = 0,
+    WD_DISCONNECTED,
+    WD_RECONNECTING,
+} wd_state_t;
+
+enum {
+    STALL_SOF = 1,
+    STALL_HID = 2,
+};
+
+static reset_reason_t reset_reason = RESET_REASON_POWER_ON;
+static bool paused = false;
+
+static wd_state_t state = WD_MONITOR;
+static uint32_t state_since_us = 0;
+static uint32_t stall_us = 0;
+static uint32_t reconnect_mounts = 0;
+
+static uint32_t last_call_us = 0;
+static uint32_t last_sof = 0;
+static uint32_t sof_change_us = 0;
+static bool hid_was_busy = false;
+static uint32_t hid_busy_since_us = 0;
+static uint32_t hid_stall_ms = WD_HID_STALL_MS;
+
+void usb_watchdog_init(void) {
+    if (watchdog_caused_reboot() && watchdog_hw->scratch[WD_SCRATCH_MAGIC] == WD_MAGIC) {
+        reset_reason = (reset_reason_t)watchdog_hw->scratch[WD_SCRATCH_REASON];
+        watchdog_hw->scratch[WD_SCRATCH_REBOOTS]++;
+    } else if (watchdog_enable_caused_reboot()) {
+        reset_reason = RESET_REASON_HANG;
+        watchdog_hw->scratch[WD_SCRATCH_REBOOTS]++;
+    } else {
+        reset_reason = RESET_REASON_POWER_ON;
+        watchdog_hw->scratch[WD_SCRATCH_REBOOTS] = 0;
+    }
+    watchdog_hw->scratch[WD_SCRATCH_MAGIC] = 0;
+    LOG("usb watchdog: reset reason %d (%d watchdog resets)",
+        reset_reason, watchdog_hw->scratch[WD_SCRATCH_REBOOTS]);
+    
+    last_call_us = time_us_32();
+    watchdog_enable(WD_HW_TIMEOUT_MS, true);
+}
+
+// A reconexão não trouxe o host de volta: reboot com o motivo gravado
+static void escalate(void) {
+    watchdog_hw->scratch[WD_SCRATCH_MAGIC] = WD_MAGIC;
+    watchdog_hw->scratch[WD_SCRATCH_REASON] = RESET_REASON_USB_STALL;
+    watchdog_reboot(0, 0, 1);
+    while (true) tight_loop_contents();
+}
+
+static void baseline(uint32_t now, uint32_t sof_count) {
+    last_sof = sof_count;
+    sof_change_us = now;
+    hid_was_busy = false;
+    hid_busy_since_us = now;
+}
+
+static bool stall(int cause, uint32_t now, uint32_t mount_count) {
+    LOG("usb watchdog: stall (cause %d), reconnecting", cause);
+    tud_disconnect();
+    state = WD_DISCONNECTED;
+    state_since_us = now;
+    stall_us = now;
+    reconnect_mounts = mount_count;
+    return true;
+}
+
+bool usb_watchdog_task(bool active, uint32_t sof_count, uint32_t mount_count) {
+    uint32_t now = time_us_32();
+    uint32_t gap_us = now - last_call_us;
+    last_call_us = now;
+    
+    if (!paused) {
+        watchdog_update();
+    }
+    
+    switch (state) {
+        case WD_DISCONNECTED:
+            if (now - state_since_us >= WD_RECONNECT_DELAY_MS * 1000) {
+                tud_connect();
+                state = WD_RECONNECTING;
+                state_since_us = now;
+            }
+            return false;
+        case WD_RECONNECTING:
+            if (mount_count != reconnect_mounts) {
+                LOG("usb watchdog: recovered in %d us", now - stall_us);
+                state = WD_MONITOR;
+                baseline(now, sof_count);
+            } else if (now - state_since_us >= WD_RECOVER_MS * 1000) {
+                escalate();
+            }
+            return false;
+        default:
+            break;
+    }
+    
+    // Sem observar (inativo, ou o laço ficou parado): recomeça a contagem
+    if (!active || gap_us > WD_SOF_STALL_MS * 1000 / 2) {
+        baseline(now, sof_count);
+        return false;
+    }
+    
+    if (sof_count != last_sof) {
+        last_sof = sof_count;
+        sof_change_us = now;
+    } else if (now - sof_change_us >= WD_SOF_STALL_MS * 1000) {
+        return stall(STALL_SOF, now, mount_count);
+    }
+    
+    // Relatório na fila conta a partir do envio; só uma transferência lida
+    // pelo host zera o recuo (host que nunca abre o mouse reconecta cada vez
+    // menos, até WD_HID_STALL_MAX_MS)
+    if (tud_hid_ready()) {
+        if (hid_was_busy) hid_stall_ms = WD_HID_STALL_MS;
+        hid_was_busy = false;
+        hid_busy_since_us = now;
+    } else {
+        hid_was_busy = true;
+        if (now - hid_busy_since_us >= hid_stall_ms * 1000) {
+            hid_stall_ms = MIN(hid_stall_ms * 2, WD_HID_STALL_MAX_MS);
+            return stall(STALL_HID, now, mount_count);
+        }
+    }
+    return false;
+}
+
+void usb_watchdog_prepare_reboot(reset_reason_t reason) {
+    watchdog_hw->scratch[WD_SCRATCH_MAGIC] = WD_MAGIC;
+    watchdog_hw->scratch[WD_SCRATCH_REASON] = reason;
+    usb_watchdog_pause(true);
+}
+
+void usb_watchdog_pause(bool pause) {
+    if (pause == paused) return;
+    paused = pause;
+    if (pause) {
+        watchdog_disable();
+    } else {
+        // Reboot planejado que não aconteceu: o próximo reset não é dele
+        watchdog_hw->scratch[WD_SCRATCH_MAGIC] = 0;
+        watchdog_enable(WD_HW_TIMEOUT_MS, true);
+    }
+}
+
+reset_reason_t usb_watchdog_reset_reason(void) {
+    return reset_reason;
+}
+
+uint32_t usb_watchdog_reboots(void) {
+    return watchdog_hw->scratch[WD_SCRATCH_REBOOTS];
+}
@@ -0,0 +1,40 @@
+#ifndef USB_WATCHDOG_H_
+#define USB_WATCHDOG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Supervisor do USB. Com o dispositivo montado e ativo, o SOF (1 por ms) tem
+// que avançar e um relatório HID na fila tem que ser lido pelo host. Sem
+// progresso o supervisor desconecta e reconecta (tud_disconnect/connect); se
+// a re-enumeração não vier, reinicia pelo watchdog. O watchdog de hardware
+// também reinicia se usb_watchdog_task() parar de ser chamada. O motivo do
+// último reset sobrevive ao reboot nos registradores scratch do watchdog.
+
+typedef enum {
+    RESET_REASON_POWER_ON = 0,  // Power-on, pino RUN ou reboot do bootrom (UF2)
+    RESET_REASON_HANG,          // Laço parado: o watchdog não foi alimentado
+    RESET_REASON_USB_STALL,     // Reconexão sem re-enumeração
+    RESET_REASON_UPDATE,        // Firmware novo instalado pelo CMD_FW_COMMIT
+} reset_reason_t;
+
+// Lê o motivo do reset e liga o watchdog de hardware
+void usb_watchdog_init(void);
+
+// Chamado a cada iteração. `active` = montado e fora do suspend; `sof_count`
+// e `mount_count` são contadores crescentes do firmware. Retorna true quando
+// acabou de desconectar o dispositivo para recuperar um travamento.
+bool usb_watchdog_task(bool active, uint32_t sof_count, uint32_t mount_count);
+
+// Suspend USB: o laço dorme em WFI e o watchdog de hardware fica parado
+void usb_watchdog_pause(bool paused);
+
+// Reboot planejado fora deste módulo (atualização de firmware): grava o
+// motivo e desliga o watchdog de hardware, que não pode disparar no meio da
+// operação longa antes do reset. usb_watchdog_pause(false) desfaz.
+void usb_watchdog_prepare_reboot(reset_reason_t reason);
+
+reset_reason_t usb_watchdog_reset_reason(void);
+uint32_t usb_watchdog_reboots(void);   // Resets pelo watchdog desde o power-on
+
+#endif
@@ -5,6 +5,10 @@
 #include <unistd.h>
 #include <errno.h>
 #include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
 
 /* Protocol Commands - must match firmware */
 #define CMD_LED_OFF       0x00
@@ -16,6 +20,31 @@
 #define CMD_LED_MAGENTA   0x06
 #define CMD_LED_WHITE     0x07
 #define CMD_LED_CUSTOM    0x08
+#define CMD_SET_REPORT_MODE 0x40
+#define CMD_SET_TUNING    0x41
+#define CMD_RECALIBRATE   0x42
+#define CMD_GET_XIP_STATS 0x43
+#define CMD_GET_USB_STATS 0x44
+#define CMD_GET_RATE_STATS 0x45
+#define CMD_GET_BOOT_TIMES 0x46
+#define CMD_EVENT_ROUTE   0x47
+#define CMD_CALIBRATE_RANGE 0x48
+#define CMD_AXIS_BENCH    0x49
+#define CMD_FW_BEGIN      0x4A
+#define CMD_FW_DATA       0x4B
+#define CMD_FW_COMMIT     0x4C
+#define CMD_LOAD_GEN      0x4D
+
+/* Vendor-defined HID collection (hidraw backend) */
+#define USB_VID              0xCAFE
+#define USB_PID              0x4003
+#define USB_PID_ABSOLUTE     0x4002
+#define REPORT_ID_VENDOR     0x02
+#define HID_VENDOR_REPORT_SIZE 63
+
+/* Report modes */
+#define REPORT_MODE_RELATIVE 0x00
+#define REPORT_MODE_ABSOLUTE 0x01
 
 /* Events */
 #define EVENT_BTN_LEFT_PRESS    0x10
@@ -24,9 +53,133 @@
 #define EVENT_BTN_RIGHT_RELEASE 0x21
 #define EVENT_BTN_MID_PRESS     0x30
 #define EVENT_BTN_MID_RELEASE   0x31
+#define EVENT_LOAD_GEN          0x50
+#define EVENT_LOAD_TELEMETRY    0x51
 
 static volatile int keep_running = 1;
 
+/* Transport: the kernel driver (/dev/pico_mouse*) or the stock hidraw node.
+ * Over hidraw a command is a SET_FEATURE on REPORT_ID_VENDOR, its reply the
+ * following GET_FEATURE, and events arrive as input reports. The feature
+ * reply starts with a status byte: sequence number of the command in bits
+ * 7-2, state in bits 1-0. */
+#define FEATURE_PENDING   0
+#define FEATURE_READY     1
+#define FEATURE_NO_REPLY  2
+#define FEATURE_DROPPED   3
+
+static int use_hidraw = 0;
+static int hid_reply_pending = 0;
+static int hid_reply_seq = -1;      /* Sequence seen while pending, -1 = none yet */
+
+int dev_write(int fd, const void *buf, size_t len) {
+    unsigned char report[1 + HID_VENDOR_REPORT_SIZE] = { REPORT_ID_VENDOR };
+    
+    if (!use_hidraw) {
+        return write(fd, buf, len);
+    }
+    if (len > HID_VENDOR_REPORT_SIZE) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    memcpy(&report[1], buf, len);
+    if (ioctl(fd, HIDIOCSFEATURE(sizeof(report)), report) < 0) {
+        return -1;
+    }
+    hid_reply_pending = 1;
+    hid_reply_seq = -1;
+    return len;
+}
+
+/* One packet per call, like the driver; 0 = nothing for us (e.g. a mouse report) */
+int dev_read(int fd, void *buf, size_t len) {
+    unsigned char report[1 + HID_VENDOR_REPORT_SIZE];
+    int ret;
+    
+    if (!use_hidraw) {
+        return read(fd, buf, len);
+    }
+    if (hid_reply_pending) {
+        int state, seq;
+        
+        report[0] = REPORT_ID_VENDOR;
+        ret = ioctl(fd, HIDIOCGFEATURE(sizeof(report)), report);
+        if (ret < 0) {
+            return -1;
+        }
+        if (ret < 3 || report[0] != REPORT_ID_VENDOR) {
+            return 0;
+        }
+        state = report[1] & 0x03;
+        seq = report[1] >> 2;
+        
+        /* Commands are queued on the device: ask again */
+        if (state == FEATURE_PENDING) {
+            hid_reply_seq = seq;
+            usleep(2000);
+            return 0;
+        }
+        hid_reply_pending = 0;
+        if (hid_reply_seq >= 0 && seq != hid_reply_seq) {
+            /* Another command (another process) took the reply slot */
+            errno = ESTALE;
+            return -1;
+        }
+        if (state == FEATURE_DROPPED) {
+            errno = EBUSY;
+            return -1;
+        }
+        if (state == FEATURE_NO_REPLY) {
+            return 0;
+        }
+        ret -= 2;
+        if ((size_t)ret > len) {
+            ret = len;
+        }
+        memcpy(buf, &report[2], ret);
+        return ret;
+    }
+    
+    ret = read(fd, report, sizeof(report));
+    if (ret < 0) {
+        return -1;
+    }
+    if (ret < 2 || report[0] != REPORT_ID_VENDOR) {
+        return 0;
+    }
+    ret--;
+    if ((size_t)ret > len) {
+        ret = len;
+    }
+    memcpy(buf, &report[1], ret);
+    return ret;
+}
+
+/* First hidraw node belonging to the device (either report mode) */
+int open_hidraw(void) {
+    char path[32];
+    
+    for (int i = 0; i < 64; i++) {
+        struct hidraw_devinfo info;
+        int fd;
+        
+        snprintf(path, sizeof(path), "/dev/hidraw%d", i);
+        fd = open(path, O_RDWR);
+        if (fd < 0) {
+            continue;
+        }
+        if (ioctl(fd, HIDIOCGRAWINFO, &info) == 0 &&
+            (unsigned short)info.vendor == USB_VID &&
+            ((unsigned short)info.product == USB_PID ||
+             (unsigned short)info.product == USB_PID_ABSOLUTE)) {
+            use_hidraw = 1;
+            return fd;
+        }
+        close(fd);
+    }
+    return -1;
+}
+
 void signal_handler(int sig) {
     keep_running = 0;
 }
@@ -49,6 +202,24 @@ void print_usage(const char *prog) {
     printf("  white            - Set LED to white\n");
     printf("  custom R G B     - Set custom RGB color (0-255)\n");
     printf("\n");
+    printf("Device Commands:\n");
+    printf("  mode relative    - Relative mouse (PID 0x4003, boot protocol)\n");
+    printf("  mode absolute    - Absolute 16-bit mouse (PID 0x4002)\n");
+    printf("  tune DZ SENS     - Set deadzone (0-2047) and sensitivity (1-255)\n");
+    printf("  calibrate        - Re-measure joystick center\n");
+    printf("  calibrate range [S] - Capture stick end stops for S seconds (default 5)\n");
+    printf("  xipstats [reset] - XIP cache hit rate and report build time\n");
+    printf("  usbstats [reset] - Device-side USB counters (SOF, reports, drops)\n");
+    printf("  ratestats [reset]- Polling governor level and time per rate\n");
+    printf("  boottime         - Boot timings and last reset reason\n");
+    printf("  axisbench        - Time the axis transform: scalar vs SIO interpolator\n");
+    printf("  flash FILE.uf2   - Update the firmware without BOOTSEL (device reboots)\n");
+    printf("  loadgen P HZ [S] [BURST] - Synthetic events (constant|bursty|random) for S s;\n");
+    printf("                     reports throughput, loss and latency\n");
+    printf("\n");
+    printf("  --hidraw <cmd>   - Use the vendor HID collection (no kernel module)\n");
+    printf("  --device PATH <cmd> - Use this node (/dev/pico_mouseN or /dev/hidrawN)\n");
+    printf("\n");
     printf("Monitoring Commands:\n");
     printf("  monitor          - Monitor button events (Ctrl+C to stop)\n");
     printf("  test             - Run LED color test sequence\n");
@@ -68,10 +239,29 @@ const char* event_to_string(unsigned char event) {
         case EVENT_BTN_RIGHT_RELEASE: return "RIGHT BUTTON RELEASED";
         case EVENT_BTN_MID_PRESS:     return "MIDDLE BUTTON PRESSED";
         case EVENT_BTN_MID_RELEASE:   return "MIDDLE BUTTON RELEASED";
+        case EVENT_LOAD_GEN:          return "LOAD GENERATOR";
+        case EVENT_LOAD_TELEMETRY:    return "LOAD TELEMETRY";
         default:                      return "UNKNOWN EVENT";
     }
 }
 
+/* The device packs several events into one packet, [type][data] back to
+ * back. The size of each follows from its type; 0 = not an event (the zero
+ * padding of a hidraw report, or a command reply taking the rest). */
+int event_size(unsigned char type) {
+    switch (type) {
+        case EVENT_BTN_LEFT_PRESS:
+        case EVENT_BTN_LEFT_RELEASE:
+        case EVENT_BTN_RIGHT_PRESS:
+        case EVENT_BTN_RIGHT_RELEASE:
+        case EVENT_BTN_MID_PRESS:
+        case EVENT_BTN_MID_RELEASE:   return 1;
+        case EVENT_LOAD_GEN:          return 9;
+        case EVENT_LOAD_TELEMETRY:    return 16;
+        default:                      return 0;
+    }
+}
+
 int send_led_command(int fd, unsigned char cmd, unsigned char r, unsigned char g, unsigned char b) {
     unsigned char buf[4];
     int ret;
@@ -82,9 +272,9 @@ int send_led_command(int fd, unsigned char cmd, unsigned char r, unsigned char g
         buf[1] = r;
         buf[2] = g;
         buf[3] = b;
-        ret = write(fd, buf, 4);
+        ret = dev_write(fd, buf, 4);
     } else {
-        ret = write(fd, buf, 1);
+        ret = dev_write(fd, buf, 1);
     }
     
     if (ret < 0) {
@@ -95,6 +285,679 @@ int send_led_command(int fd, unsigned char cmd, unsigned char r, unsigned char g
     return 0;
 }
 
+int send_report_mode(int fd, unsigned char mode) {
+    unsigned char buf[2] = { CMD_SET_REPORT_MODE, mode };
+    
+    if (dev_write(fd, buf, sizeof(buf)) < 0) {
+        perror("write");
+        return -1;
+    }
+    
+    return 0;
+}
+
+int send_tuning(int fd, int deadzone, int sensitivity) {
+    unsigned char buf[4] = {
+        CMD_SET_TUNING,
+        deadzone & 0xFF,
+        (deadzone >> 8) & 0xFF,
+        sensitivity
+    };
+    
+    if (dev_write(fd, buf, sizeof(buf)) < 0) {
+        perror("write");
+        return -1;
+    }
+    
+    return 0;
+}
+
+int send_range_calibration(int fd, int seconds) {
+    unsigned char buf[2] = { CMD_CALIBRATE_RANGE, seconds };
+    
+    if (dev_write(fd, buf, sizeof(buf)) < 0) {
+        perror("write");
+        return -1;
+    }
+    
+    return 0;
+}
+
+int send_simple_command(int fd, unsigned char cmd) {
+    if (dev_write(fd, &cmd, 1) < 0) {
+        perror("write");
+        return -1;
+    }
+    
+    return 0;
+}
+
+/* Replies start with the command code; button events read meanwhile are skipped.
+ * Over hidraw each try that finds the reply not ready yet waits 2 ms. */
+int read_reply_tries(int fd, unsigned char cmd, unsigned char *buf, int len, int max_tries) {
+    int tries;
+    
+    for (tries = 0; tries < max_tries; tries++) {
+        int ret = dev_read(fd, buf, len);
+        
+        if (ret < 0) {
+            perror("read");
+            return -1;
+        }
+        if (ret > 0) {
+            int off = 0;
+            
+            /* Events batched ahead of the reply in the same packet */
+            while (off < ret && event_size(buf[off]) > 0) {
+                off += event_size(buf[off]);
+            }
+            if (off < ret && buf[off] == cmd) {
+                memmove(buf, &buf[off], ret - off);
+                return ret - off;
+            }
+        }
+    }
+    
+    fprintf(stderr, "Error: no reply to command 0x%02X\n", cmd);
+    return -1;
+}
+
+int read_reply(int fd, unsigned char cmd, unsigned char *buf, int len) {
+    return read_reply_tries(fd, cmd, buf, len, 32);
+}
+
+static unsigned int get_u32_le(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static void put_u32_le(unsigned char *p, unsigned int v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+int show_xip_stats(int fd, int reset) {
+    unsigned char cmd[2] = { CMD_GET_XIP_STATS, reset ? 1 : 0 };
+    unsigned char buf[64];
+    
+    if (dev_write(fd, cmd, sizeof(cmd)) < 0) {
+        perror("write");
+        return -1;
+    }
+    if (read_reply(fd, CMD_GET_XIP_STATS, buf, sizeof(buf)) < 22) {
+        return -1;
+    }
+    
+    unsigned int hit = get_u32_le(&buf[2]);
+    unsigned int acc = get_u32_le(&buf[6]);
+    unsigned int samples = get_u32_le(&buf[10]);
+    unsigned int max_us = get_u32_le(&buf[14]);
+    unsigned int total_us = get_u32_le(&buf[18]);
+    
+    printf("Hot path in RAM : %s\n", (buf[1] & 0x01) ? "yes" : "no");
+    printf("XIP accesses    : %u\n", acc);
+    printf("XIP cache hits  : %u (%.2f%%)\n", hit, acc ? 100.0 * hit / acc : 0.0);
+    printf("Reports built   : %u\n", samples);
+    printf("Build time      : avg %.1f us, max %u us\n",
+           samples ? (double)total_us / samples : 0.0, max_us);
+    return 0;
+}
+
+/* Field order of the device's usb_stats_t; newer firmware may send more */
+static const char *const usb_stat_names[] = {
+    "SOF frames",
+    "Reports sent",
+    "Reports suppressed",
+    "Reports failed",
+    "HID endpoint busy",
+    "Vendor RX bytes",
+    "Vendor TX bytes",
+    "Vendor TX full",
+    "Events dropped",
+    "Event queue peak",
+    "Mounts",
+    "Suspends",
+    "Remote wakeups",
+    "Stall reconnects",
+    "HID delay max (us)",
+};
+
+int show_usb_stats(int fd, int reset) {
+    unsigned char cmd[2] = { CMD_GET_USB_STATS, reset ? 1 : 0 };
+    unsigned char buf[64];
+    int len;
+    
+    if (dev_write(fd, cmd, sizeof(cmd)) < 0) {
+        perror("write");
+        return -1;
+    }
+    len = read_reply(fd, CMD_GET_USB_STATS, buf, sizeof(buf));
+    if (len < 2) {
+        return -1;
+    }
+    
+    int count = buf[1];
+    if (count > (len - 2) / 4) {
+        count = (len - 2) / 4;
+    }
+    for (int i = 0; i < count; i++) {
+        const char *name = i < (int)(sizeof(usb_stat_names) / sizeof(usb_stat_names[0]))
+                         ? usb_stat_names[i] : "Unknown";
+        printf("%-20s: %u\n", name, get_u32_le(&buf[2 + 4 * i]));
+    }
+    return 0;
+}
+
+int show_rate_stats(int fd, int reset) {
+    unsigned char cmd[2] = { CMD_GET_RATE_STATS, reset ? 1 : 0 };
+    unsigned char buf[64];
+    unsigned int total = 0;
+    int len;
+    
+    if (dev_write(fd, cmd, sizeof(cmd)) < 0) {
+        perror("write");
+        return -1;
+    }
+    len = read_reply(fd, CMD_GET_RATE_STATS, buf, sizeof(buf));
+    if (len < 4) {
+        return -1;
+    }
+    
+    int count = buf[3];
+    if (count > (len - 4) / 6) {
+        count = (len - 4) / 6;
+    }
+    for (int i = 0; i < count; i++) {
+        total += get_u32_le(&buf[4 + 6 * i + 2]);
+    }
+    
+    printf("Governor        : %s\n", (buf[1] & 0x01) ? "enabled" : "disabled (fixed rate)");
+    for (int i = 0; i < count; i++) {
+        const unsigned char *p = &buf[4 + 6 * i];
+        unsigned int rate = p[0] | (p[1] << 8);
+        unsigned int ms = get_u32_le(&p[2]);
+        printf("%c %5u Hz      : %10u ms (%5.1f%%)\n", i == buf[2] ? '*' : ' ',
+               rate, ms, total ? 100.0 * ms / total : 0.0);
+    }
+    return 0;
+}
+
+int show_boot_times(int fd) {
+    static const char *names[] = { "USB mounted", "First HID report", "Status LED ready" };
+    static const char *reasons[] = { "power-on", "watchdog (hang)", "watchdog (USB stall)",
+                                     "firmware update" };
+    unsigned char cmd = CMD_GET_BOOT_TIMES;
+    unsigned char buf[18];
+    int len;
+    
+    if (dev_write(fd, &cmd, 1) < 0) {
+        perror("write");
+        return -1;
+    }
+    len = read_reply(fd, CMD_GET_BOOT_TIMES, buf, sizeof(buf));
+    if (len < 13) {
+        return -1;
+    }
+    
+    for (int i = 0; i < 3; i++) {
+        unsigned int us = get_u32_le(&buf[1 + 4 * i]);
+        if (us) {
+            printf("%-17s: %8.3f ms\n", names[i], us / 1000.0);
+        } else {
+            printf("%-17s: not yet\n", names[i]);
+        }
+    }
+    if (len >= 18) {
+        printf("%-17s: %s\n", "Last reset",
+               buf[13] < sizeof(reasons) / sizeof(reasons[0]) ? reasons[buf[13]] : "unknown");
+        printf("%-17s: %u\n", "Watchdog resets", get_u32_le(&buf[14]));
+    }
+    return 0;
+}
+
+/* Same axis transform timed on the scalar path and on the SIO interpolator */
+int show_axis_bench(int fd) {
+    unsigned char cmd = CMD_AXIS_BENCH;
+    unsigned char buf[14];
+    unsigned int iterations, scalar_us, interp_us;
+    
+    if (dev_write(fd, &cmd, 1) < 0) {
+        perror("write");
+        return -1;
+    }
+    if (read_reply(fd, CMD_AXIS_BENCH, buf, sizeof(buf)) < (int)sizeof(buf)) {
+        return -1;
+    }
+    
+    iterations = get_u32_le(&buf[1]);
+    scalar_us = get_u32_le(&buf[5]);
+    interp_us = get_u32_le(&buf[9]);
+    if (iterations == 0) {
+        return -1;
+    }
+    
+    printf("Samples          : %u\n", iterations);
+    printf("Scalar           : %8u us (%.1f ns/sample)\n", scalar_us, scalar_us * 1000.0 / iterations);
+    printf("Interpolator     : %8u us (%.1f ns/sample)\n", interp_us, interp_us * 1000.0 / iterations);
+    printf("Results match    : %s\n", buf[13] ? "yes" : "NO");
+    return 0;
+}
+
+/* -------------------------------------------------------
+ *                  FIRMWARE UPDATE (UF2)
+ * -------------------------------------------------------*/
+#define UF2_MAGIC_START0     0x0A324655
+#define UF2_MAGIC_START1     0x9E5D5157
+#define UF2_MAGIC_END        0x0AB16F30
+#define UF2_FLAG_NOT_MAIN_FLASH 0x00000001
+#define UF2_FLAG_FAMILY_ID   0x00002000
+#define UF2_FAMILY_RP2040    0xE48BFF56
+#define UF2_BLOCK_SIZE       512
+#define RP2040_FLASH_BASE    0x10000000
+#define RP2040_FLASH_MAX     (16 * 1024 * 1024)
+
+#define FW_CHUNK_SIZE        58     /* [0x4B][offset][data] fits a 63-byte HID report */
+#define FW_WINDOW_DRIVER     3      /* Device command queue holds 4: one slot stays free */
+#define FW_REPLY_TRIES       2000   /* Sector erase / final CRC over hidraw (2 ms per try) */
+
+#define FW_OK                0
+#define FW_ERR_OFFSET        3
+
+static const char *const fw_status_names[] = {
+    "ok", "no update in progress or install already pending", "bad size", "out of order",
+    "flash error", "CRC mismatch", "not an RP2040 flash image",
+    "firmware built without PICO_MOUSE_FW_UPDATE (use BOOTSEL)"
+};
+
+static const char *fw_status_name(unsigned char status) {
+    if (status < sizeof(fw_status_names) / sizeof(fw_status_names[0])) {
+        return fw_status_names[status];
+    }
+    return "unknown";
+}
+
+/* CRC-32/MPEG-2 (no reflection, no final XOR), as checked by the firmware */
+static unsigned int crc32_mpeg2(const unsigned char *data, unsigned int len) {
+    unsigned int crc = 0xFFFFFFFF;
+    
+    while (len--) {
+        crc ^= (unsigned int)*data++ << 24;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/* Flattens the UF2 main-flash blocks into one image starting at offset 0;
+ * gaps are left erased (0xFF). Caller frees *image. */
+static int load_uf2(const char *path, unsigned char **image, unsigned int *size) {
+    unsigned char block[UF2_BLOCK_SIZE];
+    unsigned char *buf;
+    unsigned int end = 0;
+    FILE *f = fopen(path, "rb");
+    
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    buf = malloc(RP2040_FLASH_MAX);
+    if (!buf) {
+        fclose(f);
+        return -1;
+    }
+    memset(buf, 0xFF, RP2040_FLASH_MAX);
+    
+    while (fread(block, 1, sizeof(block), f) == sizeof(block)) {
+        unsigned int flags = get_u32_le(&block[8]);
+        unsigned int addr = get_u32_le(&block[12]);
+        unsigned int len = get_u32_le(&block[16]);
+        
+        if (get_u32_le(&block[0]) != UF2_MAGIC_START0 ||
+            get_u32_le(&block[4]) != UF2_MAGIC_START1 ||
+            get_u32_le(&block[508]) != UF2_MAGIC_END) {
+            continue;
+        }
+        if ((flags & UF2_FLAG_NOT_MAIN_FLASH) ||
+            ((flags & UF2_FLAG_FAMILY_ID) && get_u32_le(&block[28]) != UF2_FAMILY_RP2040)) {
+            continue;
+        }
+        if (len > 476 || addr < RP2040_FLASH_BASE ||
+            addr - RP2040_FLASH_BASE + len > RP2040_FLASH_MAX) {
+            fprintf(stderr, "Error: UF2 block at 0x%08X is outside the flash\n", addr);
+            free(buf);
+            fclose(f);
+            return -1;
+        }
+        memcpy(&buf[addr - RP2040_FLASH_BASE], &block[32], len);
+        if (addr - RP2040_FLASH_BASE + len > end) {
+            end = addr - RP2040_FLASH_BASE + len;
+        }
+    }
+    fclose(f);
+    
+    if (end == 0) {
+        fprintf(stderr, "Error: %s has no RP2040 flash blocks\n", path);
+        free(buf);
+        return -1;
+    }
+    *image = buf;
+    *size = end;
+    return 0;
+}
+
+static int send_fw_chunk(int fd, const unsigned char *image, unsigned int size, unsigned int offset) {
+    unsigned char buf[5 + FW_CHUNK_SIZE];
+    unsigned int len = size - offset < FW_CHUNK_SIZE ? size - offset : FW_CHUNK_SIZE;
+    
+    buf[0] = CMD_FW_DATA;
+    put_u32_le(&buf[1], offset);
+    memcpy(&buf[5], &image[offset], len);
+    if (dev_write(fd, buf, 5 + len) < 0) {
+        perror("write");
+        return -1;
+    }
+    return len;
+}
+
+/* Streams the image into the device's staging slot with up to `window`
+ * chunks in flight, then asks it to verify and install. A chunk the device
+ * rejects as out of order restarts the stream from the offset it reports. */
+/* One packet of CMD_FW_DATA replies. On the driver the device may pack
+ * several 6-byte replies (and events) into one 64-byte packet: every reply
+ * in it is consumed. The last offset wins; FW_ERR_OFFSET sets *resync and
+ * any other error is returned in *status. */
+static int read_fw_data_replies(int fd, int *in_flight, unsigned int *acked,
+                                int *resync, unsigned char *status) {
+    unsigned char pkt[64];
+    int n = read_reply_tries(fd, CMD_FW_DATA, pkt, sizeof(pkt), FW_REPLY_TRIES);
+    
+    if (n < 6) {
+        return -1;
+    }
+    for (int off = 0; off + 6 <= n && pkt[off] == CMD_FW_DATA; off += 6) {
+        (*in_flight)--;
+        *acked = get_u32_le(&pkt[off + 2]);
+        if (pkt[off + 1] == FW_ERR_OFFSET) {
+            *resync = 1;
+        } else if (pkt[off + 1] != FW_OK && *status == FW_OK) {
+            *status = pkt[off + 1];
+        }
+    }
+    return 0;
+}
+
+int flash_firmware(int fd, const char *path) {
+    unsigned char *image;
+    unsigned char buf[9];
+    unsigned int size, crc, sent, acked = 0;
+    int window = use_hidraw ? 1 : FW_WINDOW_DRIVER;
+    int in_flight = 0;
+    int ret = -1;
+    
+    if (load_uf2(path, &image, &size) < 0) {
+        return -1;
+    }
+    crc = crc32_mpeg2(image, size);
+    printf("Image: %u bytes, CRC-32 0x%08X\n", size, crc);
+    
+    buf[0] = CMD_FW_BEGIN;
+    put_u32_le(&buf[1], size);
+    put_u32_le(&buf[5], crc);
+    if (dev_write(fd, buf, 9) < 0) {
+        perror("write");
+        goto out;
+    }
+    if (read_reply(fd, CMD_FW_BEGIN, buf, 6) < 6) {
+        goto out;
+    }
+    if (buf[1] != FW_OK) {
+        fprintf(stderr, "Error: update refused: %s (slot holds %u bytes)\n",
+                fw_status_name(buf[1]), get_u32_le(&buf[2]));
+        goto out;
+    }
+    
+    sent = 0;
+    while (acked < size) {
+        unsigned char status = FW_OK;
+        int resync = 0;
+        
+        while (in_flight < window && sent < size) {
+            int len = send_fw_chunk(fd, image, size, sent);
+            if (len < 0) {
+                goto out;
+            }
+            sent += len;
+            in_flight++;
+        }
+        if (read_fw_data_replies(fd, &in_flight, &acked, &resync, &status) < 0) {
+            goto out;
+        }
+        if (resync) {
+            /* Out of order: the rest of the window is stale too */
+            while (in_flight > 0) {
+                if (read_fw_data_replies(fd, &in_flight, &acked, &resync, &status) < 0) {
+                    goto out;
+                }
+            }
+            sent = acked;
+        }
+        if (status != FW_OK) {
+            fprintf(stderr, "\nError: chunk at %u: %s\n", acked, fw_status_name(status));
+            goto out;
+        }
+        printf("\rWriting: %3u%%", (unsigned int)((unsigned long long)acked * 100 / size));
+        fflush(stdout);
+    }
+    printf("\n");
+    
+    buf[0] = CMD_FW_COMMIT;
+    if (dev_write(fd, buf, 1) < 0) {
+        perror("write");
+        goto out;
+    }
+    if (read_reply_tries(fd, CMD_FW_COMMIT, buf, 2, FW_REPLY_TRIES) < 2) {
+        goto out;
+    }
+    if (buf[1] != FW_OK) {
+        fprintf(stderr, "Error: verification failed: %s\n", fw_status_name(buf[1]));
+        goto out;
+    }
+    printf("Image verified; the device installs it and reboots\n");
+    ret = 0;
+    
+out:
+    free(image);
+    return ret;
+}
+
+/* -------------------------------------------------------
+ *                  SYNTHETIC LOAD (STRESS TEST)
+ * -------------------------------------------------------*/
+#define LOAD_IDLE_MS         500    /* Quiet time after the run that ends the capture */
+
+static const char *const load_patterns[] = { "off", "constant", "bursty", "random" };
+
+static long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Asks the device for `seconds` of sequence-numbered events and counts what
+ * arrives. Device and host clocks are not synchronized, so latency is shown
+ * relative to the fastest event of the run (queueing and transfer jitter). */
+int run_load_test(int fd, const char *pattern_name, int rate_hz, int seconds, int burst) {
+    unsigned char cmd[6];
+    unsigned char buf[64];
+    int pattern = -1;
+    unsigned int received = 0, gaps = 0, reordered = 0, next_seq = 0;
+    unsigned int generated, ring_full, elapsed_us, skipped, lost;
+    unsigned int telemetry = 0, depth_max = 0, dev_refused = 0;
+    int axis_x = 0, axis_y = 0;
+    unsigned int last_dev_us = 0;
+    long long dev_wraps = 0;
+    long long first_rx = 0, last_rx = 0, deadline;
+    long long delay, delay_min = 0, delay_max = 0, delay_sum = 0;
+    
+    for (int i = 1; i < (int)(sizeof(load_patterns) / sizeof(load_patterns[0])); i++) {
+        if (strcmp(pattern_name, load_patterns[i]) == 0) {
+            pattern = i;
+        }
+    }
+    if (pattern < 0 || rate_hz <= 0 || rate_hz > 65535 || seconds < 0 || seconds > 255 ||
+        burst < 0 || burst > 255) {
+        fprintf(stderr, "Error: pattern must be constant, bursty or random; "
+                "rate 1-65535 Hz; 0-255 s; burst 0-255\n");
+        return -1;
+    }
+    if (seconds == 0) {
+        seconds = 5;
+    }
+    
+    signal(SIGINT, signal_handler);
+    
+    /* Events follow the channel that asked for them */
+    if (send_simple_command(fd, CMD_EVENT_ROUTE) < 0) {
+        return -1;
+    }
+    hid_reply_pending = 0;
+    
+    cmd[0] = CMD_LOAD_GEN;
+    cmd[1] = pattern;
+    cmd[2] = rate_hz & 0xFF;
+    cmd[3] = rate_hz >> 8;
+    cmd[4] = seconds;
+    cmd[5] = burst;
+    if (dev_write(fd, cmd, sizeof(cmd)) < 0) {
+        perror("write");
+        return -1;
+    }
+    if (read_reply(fd, CMD_LOAD_GEN, buf, 18) < 18) {
+        return -1;
+    }
+    if (buf[1] != pattern) {
+        fprintf(stderr, "Error: device refused %s at %d Hz\n", pattern_name, rate_hz);
+        return -1;
+    }
+    printf("Generating %s load at %d Hz for %d s...\n", pattern_name, rate_hz, seconds);
+    
+    deadline = now_us() + (long long)seconds * 1000000;
+    while (keep_running) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        long long rx;
+        int ret;
+        
+        if (poll(&pfd, 1, LOAD_IDLE_MS) == 0) {
+            if (now_us() >= deadline) {
+                break;
+            }
+            continue;
+        }
+        ret = dev_read(fd, buf, sizeof(buf));
+        rx = now_us();
+        if (ret < 0) {
+            if ((errno == EAGAIN || errno == ETIMEDOUT) && rx >= deadline) {
+                break;
+            }
+            if (errno == EAGAIN || errno == ETIMEDOUT) {
+                continue;
+            }
+            perror("read");
+            return -1;
+        }
+        
+        /* Plain and telemetry events share one sequence */
+        for (int off = 0; off < ret && event_size(buf[off]) > 0; off += event_size(buf[off])) {
+            const unsigned char *ev = &buf[off];
+            unsigned int seq, dev_us;
+            
+            if (ev[0] != EVENT_LOAD_GEN && ev[0] != EVENT_LOAD_TELEMETRY) {
+                continue;
+            }
+            if (off + event_size(ev[0]) > ret) {
+                break;
+            }
+            seq = get_u32_le(&ev[1]);
+            dev_us = get_u32_le(&ev[5]);
+            if (received == 0) {
+                first_rx = rx;
+            } else if (seq < next_seq) {
+                reordered++;
+            } else if (seq > next_seq) {
+                gaps++;
+            }
+            if (seq >= next_seq) {
+                next_seq = seq + 1;
+            }
+            last_rx = rx;
+            received++;
+            
+            if (ev[0] == EVENT_LOAD_TELEMETRY) {
+                axis_x = (short)(ev[9] | (ev[10] << 8));
+                axis_y = (short)(ev[11] | (ev[12] << 8));
+                if (ev[13] > depth_max) {
+                    depth_max = ev[13];
+                }
+                dev_refused = ev[14] | (ev[15] << 8);
+                telemetry++;
+            }
+            
+            /* Host µs minus device µs: constant offset + this event's delay.
+             * The device clock is 32-bit and wraps every ~71 minutes. */
+            if (received > 1 && dev_us < last_dev_us && last_dev_us - dev_us > 0x80000000u) {
+                dev_wraps += 1LL << 32;
+            }
+            last_dev_us = dev_us;
+            delay = rx - (dev_wraps + dev_us);
+            if (received == 1 || delay < delay_min) {
+                delay_min = delay;
+            }
+            if (received == 1 || delay > delay_max) {
+                delay_max = delay;
+            }
+            delay_sum += delay;
+        }
+    }
+    
+    cmd[1] = 0;
+    if (dev_write(fd, cmd, 2) < 0) {
+        perror("write");
+        return -1;
+    }
+    if (read_reply(fd, CMD_LOAD_GEN, buf, 18) < 18) {
+        return -1;
+    }
+    
+    generated = get_u32_le(&buf[2]);
+    ring_full = get_u32_le(&buf[6]);
+    elapsed_us = get_u32_le(&buf[10]);
+    skipped = get_u32_le(&buf[14]);
+    lost = generated > received ? generated - received : 0;
+    
+    printf("\n");
+    printf("Generated        : %u events in %.3f s (%.0f/s)\n", generated,
+           elapsed_us / 1e6, elapsed_us ? generated * 1e6 / elapsed_us : 0.0);
+    printf("Received         : %u events", received);
+    if (received > 1 && last_rx > first_rx) {
+        printf(" (%.0f/s sustained)", (received - 1) * 1e6 / (last_rx - first_rx));
+    }
+    printf("\n");
+    printf("Lost             : %u (%.2f%%): %u dropped on the device (queue full), %u in transit\n",
+           lost, generated ? lost * 100.0 / generated : 0.0, ring_full,
+           lost > ring_full ? lost - ring_full : 0);
+    printf("Not generated    : %u (generator fell behind the requested rate)\n", skipped);
+    printf("Telemetry        : %u records, queue depth max %u, last axes %d/%d, "
+           "%u refused at the last record\n", telemetry, depth_max, axis_x, axis_y, dev_refused);
+    printf("Sequence gaps    : %u, out of order: %u\n", gaps, reordered);
+    if (received > 0) {
+        printf("Latency above min: avg %.0f us, max %lld us\n",
+               (double)delay_sum / received - delay_min, delay_max - delay_min);
+    }
+    return 0;
+}
+
 int monitor_events(int fd) {
     unsigned char buf[64];
     int ret;
@@ -108,8 +971,14 @@ int monitor_events(int fd) {
     printf("\n");
     printf("Try clicking the buttons on your Pico Mouse...\n\n");
     
+    /* Events follow the channel that asked for them */
+    if (send_simple_command(fd, CMD_EVENT_ROUTE) < 0) {
+        return -1;
+    }
+    hid_reply_pending = 0;
+    
     while (keep_running) {
-        ret = read(fd, buf, sizeof(buf));
+        ret = dev_read(fd, buf, sizeof(buf));
         
         if (ret < 0) {
             if (errno == EAGAIN || errno == ETIMEDOUT) {
@@ -120,10 +989,13 @@ int monitor_events(int fd) {
             return -1;
         }
         
-        if (ret > 0) {
-            printf("[EVENT] 0x%02X - %s\n", buf[0], event_to_string(buf[0]));
-            fflush(stdout);
+        for (int off = 0; off < ret && buf[off] != 0; off += event_size(buf[off])) {
+            printf("[EVENT] 0x%02X - %s\n", buf[off], event_to_string(buf[off]));
+            if (event_size(buf[off]) == 0) {
+                break;
+            }
         }
+        fflush(stdout);
     }
     
     printf("\nMonitoring stopped.\n");
@@ -169,20 +1041,47 @@ int run_test_sequence(int fd) {
 }
 
 int main(int argc, char *argv[]) {
-    int fd;
+    int fd = -1;
     int ret = 0;
+    int force_hidraw = 0;
+    const char *device = NULL;
     
-    /* Try to open device */
-    fd = open("/dev/pico_mouse0", O_RDWR);
+    if (argc >= 2 && strcmp(argv[1], "--hidraw") == 0) {
+        force_hidraw = 1;
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+    }
+    if (argc >= 3 && strcmp(argv[1], "--device") == 0) {
+        device = argv[2];
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    
+    /* Try to open device: the given node, else kernel driver first, then hidraw */
+    if (device) {
+        fd = open(device, O_RDWR);
+        if (fd < 0) {
+            perror(device);
+            return 1;
+        }
+        use_hidraw = strstr(device, "hidraw") != NULL;
+    } else if (!force_hidraw) {
+        fd = open("/dev/pico_mouse0", O_RDWR);
+        if (fd < 0) {
+            fd = open("/dev/pico_mouse", O_RDWR);
+        }
+    }
     if (fd < 0) {
-        fd = open("/dev/pico_mouse", O_RDWR);
+        fd = open_hidraw();
         if (fd < 0) {
-            perror("open");
             fprintf(stderr, "\n");
             fprintf(stderr, "Error: Could not open device.\n");
             fprintf(stderr, "Please check:\n");
             fprintf(stderr, "  1. Pico is connected\n");
             fprintf(stderr, "  2. Driver is loaded: lsmod | grep pico_mouse\n");
+            fprintf(stderr, "     (or use hidraw: ls -l /dev/hidraw*)\n");
             fprintf(stderr, "  3. Device exists: ls -l /dev/pico_mouse*\n");
             fprintf(stderr, "  4. You have permissions (run as root or configure udev)\n");
             fprintf(stderr, "\n");
@@ -190,7 +1089,8 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    printf("✅ Device opened successfully (fd=%d)\n", fd);
+    printf("✅ Device opened successfully (fd=%d, %s)\n", fd,
+           use_hidraw ? "hidraw" : "driver");
     
     /* Parse command */
     if (argc < 2) {
@@ -253,6 +1153,91 @@ int main(int argc, char *argv[]) {
         printf("💡 Setting LED to custom color RGB(%d, %d, %d)...\n", r, g, b);
         ret = send_led_command(fd, CMD_LED_CUSTOM, r, g, b);
     }
+    else if (strcmp(argv[1], "mode") == 0) {
+        unsigned char mode;
+        
+        if (argc >= 3 && strcmp(argv[2], "relative") == 0) {
+            mode = REPORT_MODE_RELATIVE;
+        } else if (argc >= 3 && strcmp(argv[2], "absolute") == 0) {
+            mode = REPORT_MODE_ABSOLUTE;
+        } else {
+            fprintf(stderr, "Error: mode requires 'relative' or 'absolute'\n");
+            close(fd);
+            return 1;
+        }
+        
+        printf("🔁 Switching report mode (device will re-enumerate)...\n");
+        ret = send_report_mode(fd, mode);
+    }
+    else if (strcmp(argv[1], "tune") == 0) {
+        if (argc < 4) {
+            fprintf(stderr, "Error: tune requires DEADZONE and SENSITIVITY\n");
+            fprintf(stderr, "Example: %s tune 150 20\n", argv[0]);
+            close(fd);
+            return 1;
+        }
+        
+        int deadzone = atoi(argv[2]);
+        int sensitivity = atoi(argv[3]);
+        
+        if (deadzone < 0 || deadzone > 2047 || sensitivity < 1 || sensitivity > 255) {
+            fprintf(stderr, "Error: deadzone must be 0-2047 and sensitivity 1-255\n");
+            close(fd);
+            return 1;
+        }
+        
+        printf("🎚️  Setting deadzone=%d sensitivity=%d...\n", deadzone, sensitivity);
+        ret = send_tuning(fd, deadzone, sensitivity);
+    }
+    else if (strcmp(argv[1], "calibrate") == 0 && argc >= 3 && strcmp(argv[2], "range") == 0) {
+        int seconds = argc >= 4 ? atoi(argv[3]) : 0;
+        
+        if (seconds < 0 || seconds > 60) {
+            fprintf(stderr, "Error: capture time must be 1-60 seconds (omit for the default)\n");
+            close(fd);
+            return 1;
+        }
+        
+        printf("🎯 Move the joystick to every end stop until the LED flashes (cyan = ok, red = retry)...\n");
+        ret = send_range_calibration(fd, seconds);
+    }
+    else if (strcmp(argv[1], "calibrate") == 0) {
+        printf("🎯 Recalibrating joystick (keep it centered)...\n");
+        ret = send_simple_command(fd, CMD_RECALIBRATE);
+    }
+    else if (strcmp(argv[1], "xipstats") == 0) {
+        ret = show_xip_stats(fd, argc >= 3 && strcmp(argv[2], "reset") == 0);
+    }
+    else if (strcmp(argv[1], "usbstats") == 0) {
+        ret = show_usb_stats(fd, argc >= 3 && strcmp(argv[2], "reset") == 0);
+    }
+    else if (strcmp(argv[1], "ratestats") == 0) {
+        ret = show_rate_stats(fd, argc >= 3 && strcmp(argv[2], "reset") == 0);
+    }
+    else if (strcmp(argv[1], "boottime") == 0) {
+        ret = show_boot_times(fd);
+    }
+    else if (strcmp(argv[1], "axisbench") == 0) {
+        ret = show_axis_bench(fd);
+    }
+    else if (strcmp(argv[1], "flash") == 0) {
+        if (argc < 3) {
+            fprintf(stderr, "Usage: %s flash <firmware.uf2>\n", argv[0]);
+            close(fd);
+            return 1;
+        }
+        ret = flash_firmware(fd, argv[2]);
+    }
+    else if (strcmp(argv[1], "loadgen") == 0) {
+        if (argc < 4) {
+            fprintf(stderr, "Usage: %s loadgen constant|bursty|random RATE_HZ [SECONDS] [BURST]\n", argv[0]);
+            fprintf(stderr, "Example: %s loadgen bursty 4000 10 16\n", argv[0]);
+            close(fd);
+            return 1;
+        }
+        ret = run_load_test(fd, argv[2], atoi(argv[3]), argc >= 5 ? atoi(argv[4]) : 0,
+                            argc >= 6 ? atoi(argv[5]) : 0);
+    }
     else if (strcmp(argv[1], "monitor") == 0) {
         ret = monitor_events(fd);
     }